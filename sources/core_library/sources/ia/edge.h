@@ -27,20 +27,26 @@
 #include <algorithm>
 #include "utilities/basic_wrappers.h"
 
+///A class representing an edge, encoded by its two extremes (the lowest first)
+/*!
+ * The extremes are stored inline, thus creating an Edge does not allocate memory.
+ */
 class Edge
 {
 public:
     Edge()
     {
-        this->vertices = { -1, -1 };
+        this->vertices[0] = -1;
+        this->vertices[1] = -1;
     }
 
     Edge(itype v1, itype v2)
     {
-        this->vertices = { std::min(v1,v2), std::max(v1,v2) };
+        this->vertices[0] = std::min(v1,v2);
+        this->vertices[1] = std::max(v1,v2);
     }
 
-    inline itype EV(itype pos) { return this->vertices[pos]; }
+    inline itype EV(itype pos) const { return this->vertices[pos]; }
 
     inline friend bool operator== (const Edge &p, const Edge &q)
     {
@@ -61,7 +67,7 @@ public:
     }
 
 private:
-    ivect vertices;
+    itype vertices[2];
 };
 
 
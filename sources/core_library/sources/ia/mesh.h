@@ -31,16 +31,15 @@
 #include <iostream>
 #include <queue>
 #include <cmath>
+#include <algorithm>
 
-#include "utilities/sorting.h"
+#include "utilities/parallel.h"
+#include "utilities/mapped_vector.h"
 #include "ia/edge.h"
 #include "ia/triangle.h"
 #include "ia/vertex.h"
-
-/*
-Return true iff v is an extreme of the edge v1-v2
-*/
-#define is_endpoint(v,v1,v2) ( ( (v)==(v1) ) || ( (v)==(v2) ) )
+#include "ia/normal_field.h"
+#include "ia/vt_star.h"
 
 using namespace std;
 ///A class representing a generic mesh parametrized by the type of top simplexes
@@ -68,32 +67,244 @@ public:
     /*!
      * \param v a Vertex& argument, representing the vertex to add
      */
-    inline void add_vertex(V& v) { this->vertices.push_back(v); }
-    ///A public method that returns the tetrahedron at the i-th position in the mesh list
+    inline void add_vertex(V& v) { this->vertices.push_back(v); this->vtstar.push_back(-1); this->normal_field.invalidate(); }
+    ///A public method that returns the VTstar of a vertex
+    /*!
+     * \param id an integer argument, representing the position of the vertex in the list
+     * \return an integer, representing the position of a triangle incident in the vertex
+     */
+    inline itype get_VTstar(itype id) { return this->vtstar[id]; }
+    ///A public method that sets the VTstar of a vertex
+    /*!
+     * \param id an integer argument, representing the position of the vertex in the list
+     * \param t an integer argument, representing the position of a triangle incident in the vertex
+     */
+    inline void set_VTstar(itype id, itype t) { this->vtstar[id] = t; }
+    ///A public method that returns the triangle at the i-th position in the mesh list
     /*!
+     * The triangle is a view on the TV and TT arrays of the mesh,
+     * and it is valid until a new triangle is added to the mesh
+     *
      * \param id an integer argument, representing the position in the list
-     * \return a T&, the tetrahedron at the id-th position in the list
+     * \return a Triangle, the triangle at the id-th position in the list
      */
-    inline Triangle& get_triangle(itype id) { return this->triangles[id]; }
+    inline Triangle get_triangle(itype id) { return Triangle(&this->tv[3*id],&this->tt[3*id]); }
     ///A public method that returns the number of triangles
     /*!
      * \return an integer, representing the number of triangles
      */
-    inline itype get_triangles_num() { return this->triangles.size(); }
-    ///A public method that adds a top simplex to the triangles list
+    inline itype get_triangles_num() { return this->tv.size()/3; }
+    ///A public method that adds a triangle to the triangles list
     /*!
-     * \param t a Triangle& argument, representing the triangle to add
+     * \param v1 an integer argument, representing the first vertex of the triangle
+     * \param v2 an integer argument, representing the second vertex of the triangle
+     * \param v3 an integer argument, representing the third vertex of the triangle
      */
-    inline void add_triangle(Triangle& t) { this->triangles.push_back(t); }
+    inline void add_triangle(itype v1, itype v2, itype v3)
+    {
+        this->tv.push_back(v1); this->tv.push_back(v2); this->tv.push_back(v3);
+        this->tt.push_back(-1); this->tt.push_back(-1); this->tt.push_back(-1);
+        this->built = false;
+        this->normal_field.invalidate();
+    }
+    ///A public method that returns the memory (in bytes) allocated by the mesh arrays
+    /*!
+     * \return a size_t, the bytes allocated for vertices, VTstar, TV and TT arrays
+     */
+    inline size_t get_storage_size()
+    {
+        return this->vertices.capacity()*sizeof(V) + this->vtstar.capacity()*sizeof(itype) +
+                this->tv.capacity()*sizeof(itype) + this->tt.capacity()*sizeof(itype) +
+                this->edges_offset.capacity()*sizeof(itype) + this->edges_owner.capacity()*sizeof(itype) +
+                this->original_v_ids.capacity()*sizeof(itype) + this->original_t_ids.capacity()*sizeof(itype) +
+                this->normal_field.get_storage_size();
+    }
 
     bool build();
+    ///A public method that returns true if the VTstar and TT relations are initialized
+    inline bool is_built() { return this->built; }
+    ///A public method that returns the normals of the triangles and of the vertices, computing them if needed
+    /*!
+     * The normals are cached until the vertices or the triangles change: the procedures modifying the coordinates
+     * through get_vertex must call coordinates_changed.
+     * NOTA: the mesh must be built, and the procedure must not be called concurrently by different threads
+     * (the parallel procedures get the field before their parallel sections)
+     * \param vertex_normals a boolean, false if only the normals of the triangles are needed
+     * \return a Normal_Field&, the normals of the mesh
+     */
+    inline Normal_Field& get_normal_field(bool vertex_normals = true)
+    {
+        if(vertex_normals && !this->normal_field.has_vertex_normals())
+            this->normal_field.compute_vertex_normals(*this);
+        else if(!this->normal_field.has_triangle_normals())
+            this->normal_field.compute_triangle_normals(*this);
+        return this->normal_field;
+    }
+    ///A public method that discards the cached normals, after the coordinates of the vertices have been modified
+    inline void coordinates_changed() { this->normal_field.invalidate(); }
 
+    ///A public method that initializes vertices and TV relation as views of a memory-mapped file
+    /*!
+     * The arrays are read (and modified) in place, VTstar and TT are reset (thus build() must be called).
+     * \param map the mapped file
+     * \param vertices_offset the position (in bytes) of the vertices array in the file
+     * \param num_v the number of vertices
+     * \param tv_offset the position (in bytes) of the TV array in the file
+     * \param num_t the number of triangles
+     */
+    void map_arrays(const shared_ptr<Memory_Map> &map, size_t vertices_offset, itype num_v, size_t tv_offset, itype num_t);
+    ///A public method that initializes the VTstar and TT relations as views of a memory-mapped file
+    /*!
+     * NOTA: the mesh is considered built, thus the arrays must be consistent with the vertices and the TV relation
+     * \param map the mapped file
+     * \param vtstar_offset the position (in bytes) of the VTstar array in the file
+     * \param tt_offset the position (in bytes) of the TT array in the file
+     */
+    void map_connectivity(const shared_ptr<Memory_Map> &map, size_t vtstar_offset, size_t tt_offset);
+    ///A public method that initializes the VTstar and TT relations from two arrays (whose content is moved in the mesh)
+    /*!
+     * NOTA: the mesh is considered built, thus the arrays must be consistent with the vertices and the TV relation
+     * \param vtstar an ivect& argument, containing the VTstar of each vertex
+     * \param tt an ivect& argument, containing the TT relation (three entries per triangle)
+     */
+    void set_connectivity(ivect &vtstar, ivect &tt);
+    ///A public method that returns the vertices array (packed coordinates)
+    inline const V* get_vertices_array() const { return this->vertices.data(); }
+    ///A public method that returns the VTstar array
+    inline const itype* get_VTstar_array() const { return this->vtstar.data(); }
+    ///A public method that returns the TV array (three entries per triangle)
+    inline const itype* get_TV_array() const { return this->tv.data(); }
+    ///A public method that returns the TT array (three entries per triangle)
+    inline const itype* get_TT_array() const { return this->tt.data(); }
+
+    ///A public method that computes the implicit indexing of the mesh edges from the TT relation
+    /*!
+     * Each edge is owned by the incident triangle with the lowest position (or by its only triangle
+     * on the border), and the edges are numbered following the triangles order.
+     * The procedure does nothing if the index has been already computed.
+     * NOTA: the index is reset by build()
+     */
+    void build_edges_index();
+    ///A public method that returns the number of edges of the mesh
+    /*!
+     * NOTA: requires the edges index (see build_edges_index)
+     */
+    inline itype get_edges_num() { return this->edges_owner.size(); }
+    ///A public method that returns true if the edge in position pos of triangle t is owned by t
+    inline bool is_edge_owner(itype t, int pos)
+    {
+        itype adj = this->tt[3*t+pos];
+        return (adj == -1 || t < adj);
+    }
+    ///A public method that returns the index of the edge in position pos of triangle t (in O(1))
+    /*!
+     * NOTA: requires the edges index (see build_edges_index)
+     * \param t an integer argument, representing the triangle
+     * \param pos an integer argument, representing the position of the edge in t (i.e., the opposite vertex)
+     * \return an integer, the index of the edge
+     */
+    inline itype edge_id(itype t, int pos)
+    {
+        if(!is_edge_owner(t,pos))
+        {
+            // the edge is owned by the adjacent triangle
+            itype adj = this->tt[3*t+pos];
+            for(int j=0; j<3; j++)
+            {
+                if(this->tt[3*adj+j] == t)
+                {
+                    t = adj;
+                    pos = j;
+                    break;
+                }
+            }
+        }
+        itype id = this->edges_offset[t];
+        for(int j=0; j<pos; j++)
+        {
+            if(is_edge_owner(t,j))
+                id++;
+        }
+        return id;
+    }
+    ///A public method that returns the extremes of an edge (EV relation)
+    /*!
+     * NOTA: requires the edges index (see build_edges_index)
+     */
+    inline Edge EV(itype eid)
+    {
+        itype owner = this->edges_owner[eid];
+        return this->get_triangle(owner/3).TE(owner%3);
+    }
+
+    ///A public method that returns the triangles incident in a vertex (VT relation)
+    /*!
+     * \param center an integer argument, representing the vertex
+     * \param is_border a bool&, set to true if the vertex is on the mesh border
+     * \return an ivect, the triangles in the star of the vertex
+     */
     ivect VT(itype center, bool &is_border);
+    ///A public method that extracts the VT relation of a vertex in a caller-owned buffer
+    /*!
+     * the buffer is cleared before the extraction, thus, it can be reused without new allocations
+     */
+    void VT(itype center, ivect &triangles, bool &is_border);
     vector<Edge> VE(itype center);
+    void VE(itype center, vector<Edge> &edges);
     ivect VV(itype center);
+    void VV(itype center, ivect &vertices);
 
     ivect ET(Edge &e);
+    void ET(Edge &e, ivect &triangles);
+    ///A public method that extracts the ET relation of an edge, given its index, in a caller-owned buffer
+    /*!
+     * The triangles are read directly from the owner triangle and its adjacent one (in O(1)).
+     * NOTA: requires the edges index (see build_edges_index)
+     */
+    void ET(itype eid, ivect &triangles);
+    ///A public method that returns the (one or two) triangles incident in an edge, given its index, in O(1)
+    /*!
+     * NOTA: requires the edges index (see build_edges_index)
+     * \param t1 an integer argument, set to the triangle owning the edge
+     * \param t2 an integer argument, set to the other triangle (-1 if the edge is on the border)
+     */
+    inline void ET(itype eid, itype &t1, itype &t2)
+    {
+        itype owner = this->edges_owner[eid];
+        t1 = owner/3;
+        t2 = this->tt[owner];
+    }
     vector<Edge> EE(Edge &e);
+    void EE(Edge &e, vector<Edge> &edges);
+
+    ///A public method that visits the triangles incident in a vertex, without allocating memory
+    /*!
+     * The triangles are visited in the same order of the VT relation.
+     * \param center an integer argument, representing the vertex
+     * \param f a functor called as f(itype t) for each triangle t of the star
+     * \return true if the vertex is on the mesh border
+     */
+    template<class F> bool for_each_VT(itype center, F f);
+    ///A public method that visits the edges incident in a vertex, without allocating memory
+    /*!
+     * \param f a functor called as f(Edge &e) for each edge e, following the order of the VE relation
+     */
+    template<class F> void for_each_VE(itype center, F f);
+    ///A public method that visits the vertices adjacent to a vertex, without allocating memory
+    /*!
+     * \param f a functor called as f(itype v) for each vertex v, following the order of the VV relation
+     */
+    template<class F> void for_each_VV(itype center, F f);
+    ///A public method that visits the triangles incident in an edge, without allocating memory
+    /*!
+     * \param f a functor called as f(itype t) for each triangle t incident in e
+     */
+    template<class F> void for_each_ET(Edge &e, F f);
+    ///A public method that visits the edges adjacent to an edge, without allocating memory
+    /*!
+     * \param f a functor called as f(Edge &e) for each edge sharing a vertex with e (e excluded)
+     */
+    template<class F> void for_each_EE(Edge &e, F f);
 
     // check if the center is on the border
     bool is_boundary(int center);
@@ -105,186 +316,442 @@ public:
      */
     inline void reserve(itype numV, itype numT)
     {
-        this->vertices.reserve(numV);
-        this->triangles.reserve(numT);
+        this->reserve_vertices_space(numV);
+        this->reserve_triangles_space(numT);
+    }
+    ///A public method that sets the number of vertices and triangles of the mesh
+    /*!
+     * The new vertices are unset and the new triangles must be initialized with set_triangle,
+     * thus different threads can fill the arrays in parallel.
+     * \param numV an itype, represents the number of mesh vertices
+     * \param numT an itype, represents the number of mesh triangles
+     */
+    inline void resize(itype numV, itype numT)
+    {
+        this->vertices.resize(numV);
+        this->vtstar.assign(numV,-1);
+        this->tv.resize(3*numT);
+        this->tt.assign(3*numT,-1);
+        this->built = false;
+        this->normal_field.invalidate();
+    }
+    ///A public method that sets the vertices of a triangle
+    inline void set_triangle(itype id, itype v1, itype v2, itype v3)
+    {
+        this->tv[3*id] = v1; this->tv[3*id+1] = v2; this->tv[3*id+2] = v3;
+        this->normal_field.invalidate();
     }
     ///A public method that initializes the space needed by the vertices array
     /*!
      * \param numV an itype, represents the number of mesh vertices
      */
-    inline void reserve_vertices_space(itype numV) { this->vertices.reserve(numV); }
+    inline void reserve_vertices_space(itype numV) { this->vertices.reserve(numV); this->vtstar.reserve(numV); }
     ///A public method that initializes the space needed by the triangles array
     /*!
      * \param numT an itype, represents the number of mesh triangles
      */
-    inline void reserve_triangles_space(itype numT) { this->triangles.reserve(numT); }
+    inline void reserve_triangles_space(itype numT) { this->tv.reserve(3*numT); this->tt.reserve(3*numT); }
+
+    ///A public method that permutes the vertices and the triangles of the mesh
+    /*!
+     * The TV relation is remapped to the new vertices positions, while VTstar, TT and the edges index
+     * are reset, thus the procedure must be followed by build().
+     * \param v_position an ivect& argument, containing the new position of each vertex
+     * \param t_position an ivect& argument, containing the new position of each triangle
+     * \param keep_original_ids a boolean, if true the inverse permutations are kept in the mesh
+     */
+    void permute(ivect &v_position, ivect &t_position, bool keep_original_ids);
+    ///A public method that returns true if the mesh keeps the positions of the vertices and triangles in the input
+    inline bool has_original_ids() { return !this->original_v_ids.empty(); }
+    ///A public method that returns the position in the input of a vertex (or the vertex if the mesh has not been permuted)
+    inline itype get_original_vertex_id(itype v) { return (this->has_original_ids()) ? this->original_v_ids[v] : v; }
+    ///A public method that returns the position in the input of a triangle (or the triangle if the mesh has not been permuted)
+    inline itype get_original_triangle_id(itype t) { return (this->has_original_ids()) ? this->original_t_ids[t] : t; }
 
 protected:
-    ///A private varible representing the vertices list of the mesh
-    vector<V> vertices;
-    ///A private varible representing the top simplexes list of the mesh
-    vector<Triangle> triangles;
+    ///A private varible representing the vertices list of the mesh (packed coordinates)
+    Mapped_Vector<V> vertices;
+    ///A private varible representing the VTstar of each vertex
+    Mapped_Vector<itype> vtstar;
+    ///A private varible representing the TV relation (three entries per triangle)
+    Mapped_Vector<itype> tv;
+    ///A private varible representing the TT relation (three entries per triangle)
+    Mapped_Vector<itype> tt;
+    ///A private varible that is true if VTstar and TT are initialized (by build or by map_connectivity)
+    bool built;
+    ///A private varible representing, for each triangle, the number of edges owned by the previous triangles
+    ivect edges_offset;
+    ///A private varible representing the owner of each edge, encoded as 3*t+pos
+    ivect edges_owner;
+    ///A private varible representing the input position of each vertex (empty if not requested by permute)
+    ivect original_v_ids;
+    ///A private varible representing the input position of each triangle (empty if not requested by permute)
+    ivect original_t_ids;
+    ///A private varible representing the cached normals of the triangles and of the vertices
+    Normal_Field normal_field;
+
+    ///A protected method that returns the maximum vertex of the edge encoded as 3*t+pos
+    inline itype edge_max_vertex(itype e)
+    {
+        itype t = e/3, pos = e%3;
+        return std::max(this->tv[3*t+(pos+1)%3],this->tv[3*t+(pos+2)%3]);
+    }
+    ///A protected method that returns true if edge e1 precedes edge e2 in a bucket
+    inline bool cmp_edges(itype e1, itype e2)
+    {
+        itype m1 = edge_max_vertex(e1), m2 = edge_max_vertex(e2);
+        return (m1 < m2) || (m1 == m2 && e1 < e2);
+    }
+};
+
+///A class that visits the triangles incident in a vertex without allocating memory
+/*!
+ * The triangles are visited in the same order of the VT relation:
+ * the visit starts from the VTstar of the vertex and, if a border is reached,
+ * it restarts from the VTstar in the opposite direction.
+ *
+ * Usage:
+ *      for(StarIterator<V> it(mesh,v); !it.end(); ++it) { itype t = *it; ... }
+ */
+template<class V> class StarIterator
+{
+public:
+    ///A constructor method
+    /*!
+     * \param mesh a Mesh<V>& argument, representing the mesh
+     * \param center an integer argument, representing the vertex
+     */
+    StarIterator(Mesh<V> &mesh, itype center) : mesh(mesh)
+    {
+        this->center = center;
+        this->start = mesh.get_VTstar(center);
+        this->current = this->start;
+        this->pred = -1;
+        this->border = false;
+    }
+    ///A public method that returns true if all the triangles have been visited
+    inline bool end() const { return this->current == -1; }
+    ///A public method that returns the current triangle
+    inline itype operator*() const { return this->current; }
+    ///A public method that returns the triangle visited before the current one
+    /*!
+     * The two triangles share an edge incident in the vertex.
+     * \return an integer, the previous triangle, or -1 if the current triangle is the first one
+     */
+    inline itype get_pred() const { return this->pred; }
+    ///A public method that returns true if the vertex has been found on the mesh border
+    /*!
+     * NOTA: the value is definitive only at the end of the visit
+     */
+    inline bool is_border() const { return this->border; }
+    ///A public method that moves to the next triangle of the star
+    inline StarIterator& operator++()
+    {
+        if(this->pred == -1) // leaving the VTstar
+        {
+            Triangle t = mesh.get_triangle(this->start);
+            this->pred = this->start;
+            this->current = t.TT((t.vertex_index(this->center)+1)%3);
+        }
+        else
+            mesh.get_triangle(this->current).next_triangle_around_v(this->center,this->current,this->pred);
 
-    void link_adj (itype t1, itype t2);
+        if(this->current == this->start) // the star has been completely visited
+            this->current = -1;
+        else if(this->current == -1 && !this->border)
+        {
+            // I hit a triangle on the border for the first time
+            // then, I visit in the opposite direction starting again from VTstar
+            // (if current is still -1 there is no need to visit the star in the opposite direction)
+            this->border = true;
+            Triangle t = mesh.get_triangle(this->start);
+            this->pred = this->start;
+            this->current = t.TT((t.vertex_index(this->center)+2)%3);
+        }
+        return *this;
+    }
+
+private:
+    Mesh<V> &mesh;
+    itype center;
+    itype start;
+    itype current;
+    itype pred;
+    bool border;
 };
 
 template<class V> Mesh<V>::Mesh()
 {
-    vertices = vector<V>();
-    triangles = vector<Triangle>();
+    built = false;
 }
 
 template<class V> Mesh<V>::Mesh(const Mesh& orig)
 {
     this->vertices = orig.vertices;
-    this->triangles = orig.triangles;
+    this->vtstar = orig.vtstar;
+    this->tv = orig.tv;
+    this->tt = orig.tt;
+    this->built = orig.built;
+    this->edges_offset = orig.edges_offset;
+    this->edges_owner = orig.edges_owner;
+    this->original_v_ids = orig.original_v_ids;
+    this->original_t_ids = orig.original_t_ids;
 }
 
 template<class V> Mesh<V>::~Mesh()
 {
     vertices.clear();
-    triangles.clear();
+    vtstar.clear();
+    tv.clear();
+    tt.clear();
+    edges_offset.clear();
+    edges_owner.clear();
+    original_v_ids.clear();
+    original_t_ids.clear();
 }
 
-#include <climits>
-
 template<class V> bool Mesh<V>::build()
 {
-    aux *tr_vec ;
-    utype k;
-    itype t1, t2;
-
-    utype num = (this->get_triangles_num()*3);
+    itype num_v = this->get_vertices_num();
+    itype num_t = this->get_triangles_num();
+    utype num = (num_t*3);
     cout<<"edges: "<<num<<endl;
 
-    tr_vec = (aux*) calloc( num , sizeof(aux) ) ;
-    if (!tr_vec)
+    this->vtstar.assign(num_v,-1);
+    this->tt.assign(num,-1);
+    this->edges_offset.clear();
+    this->edges_owner.clear();
+
+    // the edges of the triangles are bucketed by their minimum vertex (counting sort)
+    // the edge at position pos in triangle t is encoded as 3*t+pos
+    // offsets[v] is the end of the bucket of v and, after the scattering, it is its begin
+    ivect offsets;
+    ivect edges;
+    offsets.assign(num_v+1,0);
+    edges.assign(num,-1);
+    offsets[num_v] = num;
+
+    #pragma omp parallel for schedule(static)
+    for (itype t=0; t<num_t; t++)
     {
-        cerr << "failed malloc in find_adj" <<endl;
-        return false;
+        for (int i=0; i<3; i++)
+        {
+            itype v = this->tv[3*t+i];
+            // initialize the partial VT of a vertex with the first triangle incident in it
+            parallel::atomic_min(this->vtstar[v],t);
+            // count the edge opposite to v in the bucket of its minimum vertex
+            itype m = std::min(this->tv[3*t+(i+1)%3],this->tv[3*t+(i+2)%3]);
+            #pragma omp atomic
+            offsets[m]++;
+        }
     }
 
-    k = 0;
+    for (itype v=1; v<num_v; v++)
+        offsets[v] += offsets[v-1];
 
-    Edge e;
-
-    for (itype j=0; j<this->get_triangles_num(); j++)
+    #pragma omp parallel for schedule(static)
+    for (itype t=0; t<num_t; t++)
     {
-        Triangle &t = this->get_triangle(j);
-        for (itype i=0;i<t.vertices_num();i++)
+        for (int i=0; i<3; i++)
         {
-            // initialize (if unset) the partial VT of a vertex
-            if(this->get_vertex(t.TV(i)).get_VTstar()==-1)
-                this->get_vertex(t.TV(i)).set_VTstar(j);
-
-            e = t.TE(i);
-
-            tr_vec[k].t = j;
-            tr_vec[k].v1 = e.EV(0);
-            tr_vec[k].v2 = e.EV(1);
-            k++;
+            itype m = std::min(this->tv[3*t+(i+1)%3],this->tv[3*t+(i+2)%3]);
+            itype pos;
+            #pragma omp atomic capture
+            pos = --offsets[m];
+            edges[pos] = 3*t+i;
         }
     }
 
-    qsort(tr_vec,num,sizeof(aux),cmp_aux) ;
-
-    for(utype k=0;k<num-1;k++)
+    // each bucket is sorted on the maximum vertex of its edges (ties are solved on the position of the edge)
+    // and the consecutive edges with the same extremes are linked.
+    // each entry of the TT array is written only by the bucket containing the corresponding edge
+    #pragma omp parallel for schedule(dynamic,1024)
+    for (itype v=0; v<num_v; v++)
     {
-        if ( is_endpoint(tr_vec[k].v1,tr_vec[k+1].v1,tr_vec[k+1].v2) &&
-             is_endpoint(tr_vec[k].v2,tr_vec[k+1].v1,tr_vec[k+1].v2) )
-        {  /* i due triangoli hanno lo stesso lato */
-            t1 = tr_vec[k].t;
-            t2 = tr_vec[k+1].t;
-            link_adj(t1,t2);
+        itype begin = offsets[v], end = offsets[v+1];
+
+        // O(k log k) in the bucket size, as the buckets of the high-valence vertices can be large
+        std::sort(edges.begin()+begin,edges.begin()+end,[this](itype e1, itype e2) { return this->cmp_edges(e1,e2); });
+
+        for (itype k=begin; k<end-1; k++)
+        {
+            if(this->edge_max_vertex(edges[k]) == this->edge_max_vertex(edges[k+1]))
+            {
+                this->tt[edges[k]] = edges[k+1]/3;
+                this->tt[edges[k+1]] = edges[k]/3;
+            }
         }
     }
-    free(tr_vec) ;
 
+    this->built = true;
+    this->normal_field.invalidate();
     return true;
 }
 
-template<class V> void Mesh<V>::link_adj(itype t1, itype t2)
-        /* Lega t1 come adiacente di t2 e viceversa */
+template<class V> void Mesh<V>::permute(ivect &v_position, ivect &t_position, bool keep_original_ids)
 {
-    Triangle &tr1 = this->get_triangle(t1);
-    Triangle &tr2 = this->get_triangle(t2);
+    itype num_v = this->get_vertices_num();
+    itype num_t = this->get_triangles_num();
+
+    vector<V> new_vertices(num_v);
+    ivect new_tv(3*num_t);
+
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+        new_vertices[v_position[v]] = this->vertices[v];
 
-    itype i, j, k, pos1[2], pos2[2];
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
     {
-        k = 0;
-        for (i=0; ((i<3)&&(k<2)); i++)
-        {
-            for (j=0; ((j<3)&&(k<2)); j++)
-            {
-                if(tr1.TV(i) == tr2.TV(j))
-                {
-                    pos1[k] = i;
-                    pos2[k] = j;
-                    k++;
-                }
-            }
-        }
-        if (k<2)
-        {
-            cerr << "error in link_adj" <<endl;
-        }
-        else
-        {
-            tr1.set_TT(3-pos1[0]-pos1[1],t2);
-            tr2.set_TT(3-pos2[0]-pos2[1],t1);
-        }
+        for(int i=0; i<3; i++)
+            new_tv[3*t_position[t]+i] = v_position[this->tv[3*t+i]];
     }
+
+    this->vertices.swap(new_vertices);
+    this->tv.swap(new_tv);
+
+    if(keep_original_ids)
+    {
+        // composed with the previous permutation (if any)
+        ivect new_v_ids(num_v), new_t_ids(num_t);
+        for(itype v=0; v<num_v; v++)
+            new_v_ids[v_position[v]] = this->get_original_vertex_id(v);
+        for(itype t=0; t<num_t; t++)
+            new_t_ids[t_position[t]] = this->get_original_triangle_id(t);
+        this->original_v_ids.swap(new_v_ids);
+        this->original_t_ids.swap(new_t_ids);
+    }
+    else
+    {
+        this->original_v_ids.clear();
+        this->original_t_ids.clear();
+    }
+
+    this->vtstar.assign(num_v,-1);
+    this->tt.assign(3*num_t,-1);
+    this->edges_offset.clear();
+    this->edges_owner.clear();
+    this->built = false;
+    this->normal_field.invalidate();
 }
 
-template<class V> ivect Mesh<V>::VT(itype center, bool &is_border)
+template<class V> void Mesh<V>::map_arrays(const shared_ptr<Memory_Map> &map, size_t vertices_offset, itype num_v,
+                                           size_t tv_offset, itype num_t)
 {
-    ivect triangles;
+    this->vertices.map_region(map,vertices_offset,num_v);
+    this->tv.map_region(map,tv_offset,3*num_t);
+    this->vtstar.assign(num_v,-1);
+    this->tt.assign(3*num_t,-1);
+    this->edges_offset.clear();
+    this->edges_owner.clear();
+    this->original_v_ids.clear();
+    this->original_t_ids.clear();
+    this->built = false;
+    this->normal_field.invalidate();
+}
 
-    itype pred = -1;
-    itype current = this->get_vertex(center).get_VTstar();
-    triangles.push_back(current);
+template<class V> void Mesh<V>::map_connectivity(const shared_ptr<Memory_Map> &map, size_t vtstar_offset, size_t tt_offset)
+{
+    this->vtstar.map_region(map,vtstar_offset,this->get_vertices_num());
+    this->tt.map_region(map,tt_offset,3*this->get_triangles_num());
+    this->edges_offset.clear();
+    this->edges_owner.clear();
+    this->built = true;
+    this->normal_field.invalidate();
+}
 
-    itype k = this->get_triangle(current).vertex_index(center);
+template<class V> void Mesh<V>::set_connectivity(ivect &vtstar, ivect &tt)
+{
+    this->vtstar.clear();
+    this->vtstar.swap(vtstar);
+    this->tt.clear();
+    this->tt.swap(tt);
+    this->edges_offset.clear();
+    this->edges_owner.clear();
+    this->built = true;
+    this->normal_field.invalidate();
+}
 
-    //choose one side to visit
-    pred = current;
-    current = this->get_triangle(current).TT((k+1)%3);
+template<class V> void Mesh<V>::build_edges_index()
+{
+    if(!this->edges_offset.empty())
+        return;
+
+    itype num_t = this->get_triangles_num();
+    this->edges_offset.assign(num_t+1,0);
 
-    while(current != this->get_vertex(center).get_VTstar())
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
     {
-        if(current == -1) // border
+        for(int pos=0; pos<3; pos++)
         {
-            if(is_border) // if it is the second time that I get to a border I exit
-                break;
-            else
-            {
-                // otherwise I hit a triangle on the border for the first time
-                // then, I visit in the opposite direction starting again from VTstar
-                is_border = true;
-                pred = this->get_vertex(center).get_VTstar();
-                k = this->get_triangle(pred).vertex_index(center);
-                current = this->get_triangle(pred).TT((k+2)%3);
-                if(current==-1) // no need visit the star in the opposite direction
-                    break;
-            }
+            if(this->is_edge_owner(t,pos))
+                this->edges_offset[t+1]++;
         }
+    }
+
+    for(itype t=0; t<num_t; t++)
+        this->edges_offset[t+1] += this->edges_offset[t];
 
-        triangles.push_back(current);
-        this->get_triangle(current).next_triangle_around_v(center,current,pred);
+    this->edges_owner.assign(this->edges_offset[num_t],-1);
+
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
+    {
+        itype id = this->edges_offset[t];
+        for(int pos=0; pos<3; pos++)
+        {
+            if(this->is_edge_owner(t,pos))
+                this->edges_owner[id++] = 3*t+pos;
+        }
     }
+}
+
+template<class V> ivect Mesh<V>::VT(itype center, bool &is_border)
+{
+    ivect triangles;
+    this->VT(center,triangles,is_border);
     return triangles;
 }
 
+template<class V> void Mesh<V>::VT(itype center, ivect &triangles, bool &is_border)
+{
+    triangles.clear();
+    is_border = this->for_each_VT(center,[&triangles](itype t){ triangles.push_back(t); });
+}
+
+template<class V> template<class F> bool Mesh<V>::for_each_VT(itype center, F f)
+{
+    StarIterator<V> it(*this,center);
+    for(; !it.end(); ++it)
+        f(*it);
+    return it.is_border();
+}
+
 template<class V> vector<Edge> Mesh<V>::VE(itype center)
 {
     vector<Edge> edges;
+    this->VE(center,edges);
+    return edges;
+}
 
+template<class V> void Mesh<V>::VE(itype center, vector<Edge> &edges)
+{
+    edges.clear();
+    this->for_each_VE(center,[&edges](Edge &e){ edges.push_back(e); });
+}
+
+template<class V> template<class F> void Mesh<V>::for_each_VE(itype center, F f)
+{
     itype pred = -1;
-    itype current = this->get_vertex(center).get_VTstar();
+    itype current = this->vtstar[center];
+    if(current == -1) // isolated vertex
+        return;
 
     itype k = this->get_triangle(current).vertex_index(center);
 
-    edges.push_back(this->get_triangle(current).TE((k+1)%3));
+    Edge e = this->get_triangle(current).TE((k+1)%3);
+    f(e);
 
     //scelgo un giro a caso da prendere
     pred = current;
@@ -292,7 +759,7 @@ template<class V> vector<Edge> Mesh<V>::VE(itype center)
 
     bool is_border = false;
 
-    while(current != this->get_vertex(center).get_VTstar())
+    while(current != this->vtstar[center])
     {
         if(current == -1) // border
         {
@@ -303,45 +770,60 @@ template<class V> vector<Edge> Mesh<V>::VE(itype center)
                 // otherwise I hit a triangle on the border for the first time
                 // then, I visit in the opposite direction starting again from VTstar
                 is_border = true;
-                pred = this->get_vertex(center).get_VTstar();
-                Triangle &tri = this->get_triangle(pred);
+                pred = this->vtstar[center];
+                Triangle tri = this->get_triangle(pred);
                 k = tri.vertex_index(center);
                 //
-                edges.push_back(tri.TE((k+2)%3));
+                e = tri.TE((k+2)%3);
+                f(e);
                 current = tri.TT((k+2)%3);
                 if(current==-1) // no need visit the star in the opposite direction
                     break;
             }
         }
 
-        Triangle &tri = this->get_triangle(current);
+        Triangle tri = this->get_triangle(current);
         k = tri.vertex_index(center);
 
         if(tri.TT((k+1)%3) == pred)
         {
-            edges.push_back(tri.TE((k+2)%3));
+            e = tri.TE((k+2)%3);
+            f(e);
             pred = current;
             current = tri.TT((k+2)%3);
         }
         else if(tri.TT((k+2)%3) == pred)
         {
-            edges.push_back(tri.TE((k+1)%3));
+            e = tri.TE((k+1)%3);
+            f(e);
             pred = current;
             current = tri.TT((k+1)%3);
         }
     }
-
-    return edges;
 }
 
-template<class V> ivect Mesh<V>::VV(int center)
+template<class V> ivect Mesh<V>::VV(itype center)
 {
     ivect vertices;
+    this->VV(center,vertices);
+    return vertices;
+}
+
+template<class V> void Mesh<V>::VV(itype center, ivect &vertices)
+{
+    vertices.clear();
+    this->for_each_VV(center,[&vertices](itype v){ vertices.push_back(v); });
+}
+
+template<class V> template<class F> void Mesh<V>::for_each_VV(itype center, F f)
+{
     itype pred = -1;
-    itype current = this->get_vertex(center).get_VTstar();
+    itype current = this->vtstar[center];
+    if(current == -1) // isolated vertex
+        return;
 
     itype k = this->get_triangle(current).vertex_index(center);
-    vertices.push_back(this->get_triangle(current).TV((k+2)%3));
+    f(this->get_triangle(current).TV((k+2)%3));
 
     //scelgo un giro a caso da prendere
     pred = current;
@@ -349,7 +831,7 @@ template<class V> ivect Mesh<V>::VV(int center)
 
     bool is_border = false;
 
-    while(current != this->get_vertex(center).get_VTstar())
+    while(current != this->vtstar[center])
     {
         if(current == -1) // border
         {
@@ -360,84 +842,97 @@ template<class V> ivect Mesh<V>::VV(int center)
                 // otherwise I hit a triangle on the border for the first time
                 // then, I visit in the opposite direction starting again from VTstar
                 is_border = true;
-                pred = this->get_vertex(center).get_VTstar();
-                Triangle &tri = this->get_triangle(pred);
+                pred = this->vtstar[center];
+                Triangle tri = this->get_triangle(pred);
                 k = tri.vertex_index(center);
                 //
-                vertices.push_back(tri.TV((k+1)%3));
+                f(tri.TV((k+1)%3));
                 current = tri.TT((k+2)%3);
                 if(current==-1) // no need visit the star in the opposite direction
                     break;
             }
         }
 
-        Triangle &tri = this->get_triangle(current);
+        Triangle tri = this->get_triangle(current);
         k = tri.vertex_index(center);
 
         if(tri.TT((k+1)%3) == pred)
         {
-            vertices.push_back(tri.TV((k+1)%3));
+            f(tri.TV((k+1)%3));
             pred = current;
             current = tri.TT((k+2)%3);
         }
         else if(tri.TT((k+2)%3) == pred)
         {
-            vertices.push_back(tri.TV((k+2)%3));
+            f(tri.TV((k+2)%3));
             pred = current;
             current = tri.TT((k+1)%3);
         }
     }
-
-    return vertices;
 }
 
 template<class V> ivect Mesh<V>::ET(Edge &e)
 {
     ivect triangles;
-    bool is_border=false;
-    ivect vt = this->VT(e.EV(0),is_border);
-    for(auto t_id : vt)
-    {
-        Triangle &t = this->get_triangle(t_id);
-        for(int j=0;j<t.vertices_num();j++)
-        {
-            if(t.has_vertex(e.EV(1)))
-            {
-                triangles.push_back(t_id);
-                break;
-            }
-        }
-    }
-
+    this->ET(e,triangles);
     return triangles;
 }
 
-template<class V> vector<Edge> Mesh<V>::EE(Edge &e)
+template<class V> void Mesh<V>::ET(Edge &e, ivect &triangles)
 {
-    vector<Edge> ve0 = this->VE(e.EV(0));
-    vector<Edge> ve1 = this->VE(e.EV(1));
+    triangles.clear();
+    this->for_each_ET(e,[&triangles](itype t){ triangles.push_back(t); });
+}
 
-    ve0.insert(std::end(ve0), std::begin(ve1), std::end(ve1));
-    ve0.erase(std::remove(ve0.begin(), ve0.end(), e), ve0.end());
-    return ve0;
+template<class V> void Mesh<V>::ET(itype eid, ivect &triangles)
+{
+    triangles.clear();
+    itype owner = this->edges_owner[eid];
+    triangles.push_back(owner/3);
+    if(this->tt[owner] != -1)
+        triangles.push_back(this->tt[owner]);
 }
 
-template<class V> bool Mesh<V>::is_boundary(int center)
+template<class V> template<class F> void Mesh<V>::for_each_ET(Edge &e, F f)
 {
-    itype pred = -1;
-    itype current = this->get_vertex(center).VTstar();
-    itype k = this->get_triangle(current).vertex_index(center);
-    pred = current;
-    current = this->get_triangle(current).TT((k+1)%3);
+    itype v1 = e.EV(1);
+    this->for_each_VT(e.EV(0),[this,v1,&f](itype t_id)
+    {
+        if(this->get_triangle(t_id).has_vertex(v1))
+            f(t_id);
+    });
+}
 
-    while(current != this->get_vertex(center).VTstar())
+template<class V> vector<Edge> Mesh<V>::EE(Edge &e)
+{
+    vector<Edge> edges;
+    this->EE(e,edges);
+    return edges;
+}
+
+template<class V> void Mesh<V>::EE(Edge &e, vector<Edge> &edges)
+{
+    edges.clear();
+    this->for_each_EE(e,[&edges](Edge &e2){ edges.push_back(e2); });
+}
+
+template<class V> template<class F> void Mesh<V>::for_each_EE(Edge &e, F f)
+{
+    auto visit = [&e,&f](Edge &e2)
     {
-        if(current == -1)
-            return true;
-        this->get_triangle(current).next_triangle_around_v(center,current,pred);
-    }
+        if(e2 != e)
+            f(e2);
+    };
+    this->for_each_VE(e.EV(0),visit);
+    this->for_each_VE(e.EV(1),visit);
+}
 
-    return false;
+template<class V> bool Mesh<V>::is_boundary(int center)
+{
+    StarIterator<V> it(*this,center);
+    while(!it.end() && !it.is_border())
+        ++it;
+    return it.is_border();
 }
 
 /** @typedef Abs_Mesh
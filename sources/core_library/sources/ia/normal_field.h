@@ -0,0 +1,186 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NORMAL_FIELD_H
+#define	_NORMAL_FIELD_H
+
+#include <vector>
+
+#include "ia/vec.h"
+#include "ia/triangle.h"
+#include "utilities/parallel.h"
+
+///A class representing the unit normals of the triangles and of the vertices of a mesh
+/*!
+ * The normals are packed in two arrays, computed in parallel for the whole mesh (the vertex normals only when requested).
+ * The normal of a vertex is the sum of the normals of its incident triangles, weighted by their angle in the vertex
+ * and accumulated in the order of the VT relation (as computed by the curvature estimators visiting the stars).
+ *
+ * The field is cached on the mesh (see Mesh::get_normal_field) and it is invalidated when the vertices
+ * or the triangles of the mesh change.
+ */
+class Normal_Field
+{
+public:
+    ///A constructor method
+    Normal_Field() { triangles_valid = vertices_valid = false; }
+
+    ///A public method that returns true if the normals of the triangles are computed on the current mesh
+    inline bool has_triangle_normals() { return this->triangles_valid; }
+    ///A public method that returns true if the normals of the vertices are computed on the current mesh
+    inline bool has_vertex_normals() { return this->vertices_valid; }
+    ///A public method that discards the normals
+    inline void invalidate()
+    {
+        this->triangles_valid = this->vertices_valid = false;
+        this->triangle_normals.clear();
+        this->vertex_normals.clear();
+    }
+    ///A public method that computes the normals of all the triangles
+    /*!
+     * \param mesh the mesh
+     */
+    template<class M> void compute_triangle_normals(M &mesh);
+    ///A public method that computes the normals of all the vertices (and of the triangles, if needed)
+    /*!
+     * NOTA: the mesh must be built (the vertex normals follow the VT relation)
+     * \param mesh the mesh
+     */
+    template<class M> void compute_vertex_normals(M &mesh);
+
+    ///A public method that discards the normals of the vertices and allocates them as null vectors, to be set one by one
+    /*!
+     * NOTA: the visits of the stars that set the normals must use vertex_normal, and validate_vertex_normals must be called at the end
+     * \param num_v the number of vertices of the mesh
+     */
+    inline void reset_vertex_normals(itype num_v)
+    {
+        this->vertices_valid = false;
+        this->vertex_normals.assign(num_v,Vec3());
+    }
+    ///A public method that sets the unit normal of a vertex (see reset_vertex_normals)
+    inline void set_vertex_normal(itype v, const Vec3 &n) { this->vertex_normals[v] = n; }
+    ///A public method that marks the normals of the vertices as computed on the current mesh (see reset_vertex_normals)
+    inline void validate_vertex_normals() { this->vertices_valid = true; }
+
+    ///A public method that returns the unit normal of a triangle
+    inline const Vec3& get_triangle_normal(itype t) const { return this->triangle_normals[t]; }
+    ///A public method that returns the unit normal of a vertex (the null vector for an isolated vertex)
+    inline const Vec3& get_vertex_normal(itype v) const { return this->vertex_normals[v]; }
+    ///A public method that returns the memory (in bytes) allocated by the normals
+    inline size_t get_storage_size() const
+    {
+        return (this->triangle_normals.capacity() + this->vertex_normals.capacity())*sizeof(Vec3);
+    }
+
+    ///A public method that returns the unit normal of the triangle p0 p1 p2
+    static inline Vec3 triangle_normal(const Vec3 &p0, const Vec3 &p1, const Vec3 &p2)
+    {
+        Vec3 n = (p0 - p1).cross(p0 - p2);
+        return n / n.norm();
+    }
+    ///A public method that returns the unit normal of a vertex, given the sum of the normals of its num incident triangles
+    ///weighted by their angle in the vertex (summed in the order of the VT relation) and the sum of the angles
+    static inline Vec3 vertex_normal(Vec3 vnorm, itype num, coord_type totang)
+    {
+        vnorm /= (num*totang);
+        return vnorm / vnorm.norm();
+    }
+    ///A public method that returns the cosinus of the angle in p2 of the triangle p1 p2 p3 (clamped in [-1,1])
+    static inline coord_type cos_angle(const Vec3 &p1, const Vec3 &p2, const Vec3 &p3)
+    {
+        Vec3 e21 = p1 - p2;
+        Vec3 e23 = p3 - p2;
+        coord_type costeta = e21.dot(e23)/(e21.norm()*e23.norm());
+        if (costeta>1.0) costeta = 1.0;
+        if (costeta<-1.0) costeta = -1.0;
+        return costeta;
+    }
+
+private:
+    ///A private variable that is true if the normals of the triangles are computed on the current mesh
+    bool triangles_valid;
+    ///A private variable that is true if the normals of the vertices are computed on the current mesh
+    bool vertices_valid;
+    ///A private variable representing the normal of each triangle
+    std::vector<Vec3> triangle_normals;
+    ///A private variable representing the normal of each vertex
+    std::vector<Vec3> vertex_normals;
+};
+
+template<class M> void Normal_Field::compute_triangle_normals(M &mesh)
+{
+    itype num_t = mesh.get_triangles_num();
+    this->triangle_normals.resize(num_t);
+
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        this->triangle_normals[t] = triangle_normal(mesh.get_vertex(tr.TV(0)),mesh.get_vertex(tr.TV(1)),mesh.get_vertex(tr.TV(2)));
+    }
+    this->triangles_valid = true;
+}
+
+template<class M> void Normal_Field::compute_vertex_normals(M &mesh)
+{
+    if(!this->triangles_valid)
+        this->compute_triangle_normals(mesh);
+    itype num_t = mesh.get_triangles_num();
+    itype num_v = mesh.get_vertices_num();
+
+    // the angle of the corner k of a triangle t is in position 3t+k: the angles are computed
+    // triangle by triangle, then the vertices only read them
+    std::vector<coord_type> angles(3*num_t);
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        for(int k=0; k<3; k++)
+            angles[3*t+k] = acos(cos_angle(mesh.get_vertex(tr.TV((k+1)%3)),mesh.get_vertex(tr.TV(k)),mesh.get_vertex(tr.TV((k+2)%3))));
+    }
+
+    this->vertex_normals.assign(num_v,Vec3());
+    // each normal depends only on its vertex, thus the result does not depend on the schedule
+    #pragma omp parallel for schedule(dynamic,1024)
+    for(itype v=0; v<num_v; v++)
+    {
+        if(mesh.get_VTstar(v) == -1)
+            continue;
+        Vec3 vnorm;
+        coord_type totang = 0.0;
+        itype num = 0;
+        mesh.for_each_VT(v,[&](itype t)
+        {
+            coord_type ang = angles[3*t+mesh.get_triangle(t).vertex_index(v)];
+            totang += ang;
+            vnorm += this->triangle_normals[t] * ang;
+            num++;
+        });
+        this->vertex_normals[v] = vertex_normal(vnorm,num,totang);
+    }
+    this->vertices_valid = true;
+}
+
+#endif	/* _NORMAL_FIELD_H */
@@ -3,30 +3,35 @@
 
 #include "ia/edge.h"
 
+///A class representing a lightweight view on a triangle of the mesh
+/*!
+ * The triangle does not own its data, but it points to the entries of the TV and TT arrays
+ * of the mesh (three consecutive indices in each array).
+ * Thus, a Triangle is cheap to copy, but it is valid only until the mesh arrays are resized.
+ */
 class Triangle
 {
 public:
-    Triangle()
-    {
-        this->vertices = { -1, -1, -1 };
-        this->adj = { -1, -1, -1 };
-    }
-
-    Triangle(itype v1, itype v2, itype v3)
+    ///A constructor method
+    /*!
+     * \param vertices a pointer to the three vertex indices of the triangle (TV relation)
+     * \param adj a pointer to the three adjacent triangles of the triangle (TT relation)
+     */
+    Triangle(itype *vertices, itype *adj)
     {
-        this->vertices = { v1, v2, v3 };
-        this->adj = { -1, -1, -1 };
+        this->vertices = vertices;
+        this->adj = adj;
     }
 
-    inline itype TV(int pos) { return this->vertices[pos]; }
+    inline itype TV(int pos) const { return this->vertices[pos]; }
 
-    inline Edge TE(int pos) { return Edge(vertices[(pos+1)%3],vertices[(pos+2)%3]); }
+    inline Edge TE(int pos) const { return Edge(vertices[(pos+1)%3],vertices[(pos+2)%3]); }
 
-    inline itype TT(int pos) { return this->adj[pos]; }
+    inline itype TT(int pos) const { return this->adj[pos]; }
 
     inline void set_TT(int pos, itype adjId) { this->adj[pos]=adjId; }
 
-    inline int vertices_num() { return 3; }
+    inline int vertices_num() const { return 3; }
 
     inline bool operator== (const Triangle &p)
     {
@@ -47,13 +52,13 @@ public:
         return b[0] && b[1] && b[2];
     }
 
-    inline bool operator!= (const Triangle p)
+    inline bool operator!= (const Triangle &p)
     {
        return !((*this)==(p));
     }
 
     //return the index of vertex v in triangle t
-    inline itype vertex_index(itype v)
+    inline itype vertex_index(itype v) const
     {
         for(int i=0; i<3; i++)
             if (TV(i)==v)
@@ -61,10 +66,10 @@ public:
         return -1;
     }
 
-    inline bool has_vertex(itype v) { return (vertex_index(v)!=-1); }
+    inline bool has_vertex(itype v) const { return (vertex_index(v)!=-1); }
 
     //return the next triangle incident in vertex v, starting from triangle 'current'
-    inline void next_triangle_around_v(itype center, itype &current, itype &pred)
+    inline void next_triangle_around_v(itype center, itype &current, itype &pred) const
     {
         int c_pos = this->vertex_index(center);
         if(this->TT((c_pos+1)%3) == pred)
@@ -93,9 +98,10 @@ public:
     }
 
 private:
-    ivect vertices;
-    ///
-    ivect adj;
+    ///A private variable pointing to the TV entries of the triangle
+    itype *vertices;
+    ///A private variable pointing to the TT entries of the triangle
+    itype *adj;
 };
 
 
@@ -0,0 +1,125 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _VEC_H
+#define	_VEC_H
+
+#include <math.h>
+#include <type_traits>
+#include "vertex.h"
+
+///A class representing a vector (or a point) of the plane, used by the geometric procedures
+/*!
+ * The class is a trivially copyable value type: its temporaries live in registers
+ * and the arithmetic compiles to straight-line code, without loops on the dimension.
+ */
+struct Vec2
+{
+    coord_type x, y;
+
+    ///A constructor method for the null vector
+    constexpr Vec2() : x(0), y(0) {}
+    ///A constructor method
+    constexpr Vec2(coord_type x, coord_type y) : x(x), y(y) {}
+    ///A constructor method projecting a vertex on the xy plane
+    explicit Vec2(const Vertex &v) : x(v.get_c(0)), y(v.get_c(1)) {}
+
+    constexpr Vec2 operator+(const Vec2 &o) const { return Vec2(x+o.x, y+o.y); }
+    constexpr Vec2 operator-(const Vec2 &o) const { return Vec2(x-o.x, y-o.y); }
+    constexpr Vec2 operator-() const { return Vec2(-x, -y); }
+    ///A public method that returns the component-wise product
+    constexpr Vec2 operator*(const Vec2 &o) const { return Vec2(x*o.x, y*o.y); }
+    constexpr Vec2 operator*(coord_type c) const { return Vec2(x*c, y*c); }
+    constexpr Vec2 operator/(coord_type c) const { return Vec2(x/c, y/c); }
+
+    inline Vec2& operator+=(const Vec2 &o) { x += o.x; y += o.y; return *this; }
+    inline Vec2& operator-=(const Vec2 &o) { x -= o.x; y -= o.y; return *this; }
+    inline Vec2& operator*=(coord_type c) { x *= c; y *= c; return *this; }
+    inline Vec2& operator/=(coord_type c) { x /= c; y /= c; return *this; }
+
+    ///A public method that returns the sum of the components
+    constexpr coord_type sum() const { return x + y; }
+    ///A public method that returns the scalar product with o
+    constexpr coord_type dot(const Vec2 &o) const { return x*o.x + y*o.y; }
+    ///A public method that returns the z component of the cross product with o
+    constexpr coord_type cross(const Vec2 &o) const { return x*o.y - y*o.x; }
+    ///A public method that returns the squared length
+    constexpr coord_type squared_norm() const { return this->dot(*this); }
+    ///A public method that returns the length
+    inline coord_type norm() const { return sqrt(this->squared_norm()); }
+};
+
+///A class representing a vector (or a point) of the 3D space, used by the geometric procedures
+/*!
+ * The class is a trivially copyable value type: its temporaries live in registers
+ * and the arithmetic compiles to straight-line code, without loops on the dimension.
+ * The sums of the components follow the order x, y, z, as the loops on the coordinates of Vertex,
+ * thus the procedures ported from Vertex compute the same values (bit by bit).
+ */
+struct Vec3
+{
+    coord_type x, y, z;
+
+    ///A constructor method for the null vector
+    constexpr Vec3() : x(0), y(0), z(0) {}
+    ///A constructor method
+    constexpr Vec3(coord_type x, coord_type y, coord_type z) : x(x), y(y), z(z) {}
+    ///A constructor method copying the coordinates of a vertex
+    Vec3(const Vertex &v) : x(v.get_c(0)), y(v.get_c(1)), z(v.get_c(2)) {}
+
+    constexpr Vec3 operator+(const Vec3 &o) const { return Vec3(x+o.x, y+o.y, z+o.z); }
+    constexpr Vec3 operator-(const Vec3 &o) const { return Vec3(x-o.x, y-o.y, z-o.z); }
+    constexpr Vec3 operator-() const { return Vec3(-x, -y, -z); }
+    ///A public method that returns the component-wise product
+    constexpr Vec3 operator*(const Vec3 &o) const { return Vec3(x*o.x, y*o.y, z*o.z); }
+    constexpr Vec3 operator*(coord_type c) const { return Vec3(x*c, y*c, z*c); }
+    constexpr Vec3 operator/(coord_type c) const { return Vec3(x/c, y/c, z/c); }
+
+    inline Vec3& operator+=(const Vec3 &o) { x += o.x; y += o.y; z += o.z; return *this; }
+    inline Vec3& operator-=(const Vec3 &o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+    inline Vec3& operator*=(coord_type c) { x *= c; y *= c; z *= c; return *this; }
+    inline Vec3& operator/=(coord_type c) { x /= c; y /= c; z /= c; return *this; }
+
+    ///A public method that returns the i-th component (no range check!)
+    constexpr coord_type operator[](int i) const { return (i == 0) ? x : ((i == 1) ? y : z); }
+    ///A public method that returns the sum of the components
+    constexpr coord_type sum() const { return x + y + z; }
+    ///A public method that returns the scalar product with o
+    constexpr coord_type dot(const Vec3 &o) const { return x*o.x + y*o.y + z*o.z; }
+    ///A public method that returns the cross product with o
+    constexpr Vec3 cross(const Vec3 &o) const { return Vec3(y*o.z - z*o.y, z*o.x - x*o.z, x*o.y - y*o.x); }
+    ///A public method that returns the squared length
+    constexpr coord_type squared_norm() const { return this->dot(*this); }
+    ///A public method that returns the length
+    inline coord_type norm() const { return sqrt(this->squared_norm()); }
+    ///A public method that returns the projection on the xy plane
+    constexpr Vec2 xy() const { return Vec2(x, y); }
+    ///A public method that returns the vertex with the same coordinates
+    inline Vertex to_vertex() const { return Vertex(x, y, z); }
+};
+
+static_assert(std::is_trivially_copyable<Vec2>::value, "Vec2 must be trivially copyable");
+static_assert(std::is_trivially_copyable<Vec3>::value, "Vec3 must be trivially copyable");
+static_assert(Vec3(1,2,3).cross(Vec3(4,5,6)).dot(Vec3(1,1,1)) == 0, "Vec3 arithmetic must be constexpr");
+
+#endif	/* _VEC_H */
@@ -25,35 +25,45 @@
 #define	_VERTEX_H
 
 #include <math.h>
-#include "ia/vt_star.h"
-
-///An inner-class, extending Vertex2D, representing a vertex in a tetrahedral mesh
-class Vertex : public VT_star
+#include <iostream>
+#include "utilities/basic_wrappers.h"
+
+///A class representing a vertex of a triangle mesh embedded in the 3D space
+/*!
+ * The coordinates are stored inline (no heap allocation and no virtual table),
+ * thus a vector of Vertex is a packed array of x,y,z triples.
+ * A point embedded in the plane has z=0.
+ * The VTstar of the vertex is not stored here, but it is kept by the mesh in a separated array.
+ */
+class Vertex
 {
 public:
     ///A constructor method
-    Vertex() : VT_star() {  }
-    ///A constructor method
-    Vertex(const Vertex& orig) : VT_star(orig) { this->coords=orig.coords; }
+    Vertex() { coords[0] = 0; coords[1] = 0; coords[2] = 0; }
     ///A constructor method for a 2D point
     /*!
      * \param x a coord_type argument, representing the x coordinate
      * \param y a coord_type argument, representing the y coordinate
      */
-    Vertex(coord_type x, coord_type y) : VT_star() { coords = { x, y }; }
+    Vertex(coord_type x, coord_type y) { coords[0] = x; coords[1] = y; coords[2] = 0; }
     ///A constructor method for a 3D point
     /*!
      * \param x a coord_type argument, representing the x coordinate
      * \param y a coord_type argument, representing the y coordinate
      * \param z a coord_type argument, representing the z coordinate
      */
-    Vertex(coord_type x, coord_type y, coord_type z) : VT_star() { coords = { x, y, z }; }
-    ///A constructor method for a nD point
-    Vertex(dvect &coords) : VT_star() { this->coords = coords; }
-    ///A constructor method for an unset nD point
-    Vertex(int dim) : VT_star() { this->coords.assign(dim,0); }
-    ///A destructor method
-    virtual ~Vertex() {}
+    Vertex(coord_type x, coord_type y, coord_type z) { coords[0] = x; coords[1] = y; coords[2] = z; }
+    ///A constructor method for a nD point (n<=3)
+    Vertex(dvect &coords)
+    {
+        for(int i=0; i<3; i++)
+            this->coords[i] = (i < (int)coords.size()) ? coords[i] : 0;
+    }
+    ///A constructor method for an unset point
+    /*!
+     * NOTA: the dimension is always 3, the argument is kept for compatibility
+     */
+    Vertex(int) { coords[0] = 0; coords[1] = 0; coords[2] = 0; }
     ///
     friend bool operator== (const Vertex& p, const Vertex &q)
     {
@@ -142,7 +152,7 @@ public:
         return *this;
     }
 
-    inline int get_dimension() const { return coords.size(); }
+    inline int get_dimension() const { return 3; }
     // no range check!
     inline void set_c(int pos, coord_type c) { this->coords[pos] = c; }
     // no range check!
@@ -192,7 +202,7 @@ public:
         return sum;
     }
 
-    inline dvect& get_coordinates() { return coords; }
+    inline dvect get_coordinates() const { return dvect(coords,coords+3); }
 
     /**
      * @brief operator <<
@@ -202,14 +212,13 @@ public:
      */
     inline friend std::ostream& operator<<(std::ostream& out, const Vertex& p)
     {
-        for(auto c : p.coords)
-            out << c << " ";
+        out << p.coords[0] << " " << p.coords[1] << " " << p.coords[2] << " ";
         return out;
     }
 
-private:    
-    ///A protected variable representing the z coordinate of the point
-    dvect coords;
+private:
+    ///A private variable representing the x,y,z coordinates of the point
+    coord_type coords[3];
 
 };
 
@@ -26,26 +26,17 @@
 
 #include "utilities/basic_wrappers.h"
 
+///A class representing a vertex of an abstract (i.e., not embedded) triangle mesh
+/*!
+ * An abstract vertex has no information besides its VTstar, which is stored by the mesh
+ * in a packed array (see Mesh::get_VTstar).
+ * Thus, this class is just an empty tag used to specialize the Mesh class.
+ */
 class VT_star
 {
 public:
     ///A constructor method
-    VT_star() { this->vtstar = -1; }
-    ///A constructor method
-    VT_star(const VT_star& orig) { this->vtstar = orig.vtstar; }
-    ///A destructor method
-    virtual ~VT_star() {}
-    ///
-    friend bool operator== (const VT_star& p, const VT_star &q) { return (p.vtstar == q.vtstar); }
-    ///
-    friend bool operator!= (const VT_star& p, const VT_star &q) { return !(p == q); }
-    ///
-    itype get_VTstar() { return this->vtstar; }
-    ///
-    void set_VTstar(itype vtstar) { this->vtstar = vtstar; }
-protected:
-    ///
-    itype vtstar;
+    VT_star() { }
 };
 
 #endif // VT_STAR_H
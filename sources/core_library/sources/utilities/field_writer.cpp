@@ -0,0 +1,185 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "field_writer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <sstream>
+
+// the file is written in chunks of 4MB
+#define FIELD_WRITER_BUFFER (1 << 22)
+
+static inline bool is_little_endian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const char*>(&one) == 1;
+}
+
+///A buffered output on a C stream (the values are appended to the buffer, written when it is full)
+class Buffered_Output
+{
+public:
+    Buffered_Output(FILE *f) : file(f), used(0), failed(false) { buffer.resize(FIELD_WRITER_BUFFER); }
+
+    inline void put(const void *data, size_t bytes)
+    {
+        if(used + bytes > buffer.size())
+            flush();
+        memcpy(&buffer[used],data,bytes);
+        used += bytes;
+    }
+    template<class T> inline void put(T value) { put(&value,sizeof(T)); }
+    inline void flush()
+    {
+        if(used > 0 && fwrite(&buffer[0],1,used,file) != used)
+            failed = true;
+        used = 0;
+    }
+    inline bool fail() { return failed; }
+
+private:
+    FILE *file;
+    vector<char> buffer;
+    size_t used;
+    bool failed;
+};
+
+bool Field_Writer::write_ply(Spatial_Mesh &mesh, string path)
+{
+    FILE *file = fopen(path.c_str(),"wb");
+    if(file == NULL)
+    {
+        cerr << "[ERROR] cannot open " << path << " for writing." << endl;
+        return false;
+    }
+    bool written = write_ply(mesh,file);
+    if(fclose(file) != 0 || !written)
+    {
+        cerr << "[ERROR] writing " << path << " failed." << endl;
+        return false;
+    }
+    return true;
+}
+
+bool Field_Writer::write_ply(Spatial_Mesh &mesh, FILE *file)
+{
+    if(!is_little_endian())
+    {
+        cerr << "[ERROR] the binary PLY output is supported only on little-endian systems." << endl;
+        return false;
+    }
+
+    itype num_v = mesh.get_vertices_num();
+    itype num_t = mesh.get_triangles_num();
+    itype num_e = (edge_fields.empty()) ? 0 : mesh.get_edges_num();
+
+    stringstream header;
+    header << "ply\nformat binary_little_endian 1.0\ncomment written by LibTri\n";
+    auto field_properties = [&header](const vector<Field> &fields)
+    {
+        for(auto &f : fields)
+            header << "property " << ((f.reals != NULL) ? "double " : (f.bytes != NULL) ? "uchar " : "int ") << f.name << "\n";
+    };
+    header << "element vertex " << num_v << "\nproperty double x\nproperty double y\nproperty double z\n";
+    field_properties(vertex_fields);
+    header << "element face " << num_t << "\nproperty list uchar int vertex_indices\n";
+    field_properties(triangle_fields);
+    if(num_e > 0)
+    {
+        header << "element edge " << num_e << "\nproperty int vertex1\nproperty int vertex2\n";
+        field_properties(edge_fields);
+    }
+    header << "end_header\n";
+
+    Buffered_Output out(file);
+    string h = header.str();
+    out.put(h.data(),h.size());
+
+    auto put_fields = [&out](const vector<Field> &fields, itype pos)
+    {
+        for(auto &f : fields)
+        {
+            if(f.reals != NULL)
+                out.put(f.reals[pos]);
+            else if(f.bytes != NULL)
+                out.put(f.bytes[pos]);
+            else
+                out.put((int32_t)f.ints[pos]);
+        }
+    };
+
+    // the position of each vertex and triangle in the input order
+    ivect v_input_pos, t_input_pos;
+    if(mesh.has_original_ids())
+    {
+        v_input_pos.resize(num_v);
+        t_input_pos.resize(num_t);
+        for(itype v=0; v<num_v; v++)
+            v_input_pos[mesh.get_original_vertex_id(v)] = v;
+        for(itype t=0; t<num_t; t++)
+            t_input_pos[mesh.get_original_triangle_id(t)] = t;
+    }
+
+    for(itype i=0; i<num_v; i++)
+    {
+        itype v = (v_input_pos.empty()) ? i : v_input_pos[i];
+        Vertex &vert = mesh.get_vertex(v);
+        for(int c=0; c<3; c++)
+            out.put(vert.get_c(c));
+        put_fields(vertex_fields,v);
+    }
+    for(itype i=0; i<num_t; i++)
+    {
+        itype t = (t_input_pos.empty()) ? i : t_input_pos[i];
+        Triangle tr = mesh.get_triangle(t);
+        out.put((uint8_t)3);
+        for(int k=0; k<3; k++)
+            out.put((int32_t)mesh.get_original_vertex_id(tr.TV(k)));
+        put_fields(triangle_fields,t);
+    }
+    // each edge is written by its triangle with the lowest input position
+    // (without a permutation, this is the order of the edges index)
+    for(itype i=0; i<num_t && num_e>0; i++)
+    {
+        itype t = (t_input_pos.empty()) ? i : t_input_pos[i];
+        Triangle tr = mesh.get_triangle(t);
+        for(int pos=0; pos<3; pos++)
+        {
+            itype adj = tr.TT(pos);
+            if(adj != -1 && mesh.get_original_triangle_id(adj) < i)
+                continue;
+            // the extremes in increasing order of input index, as Edge sorts them on the current index
+            Edge e = tr.TE(pos);
+            itype u = mesh.get_original_vertex_id(e.EV(0)), w = mesh.get_original_vertex_id(e.EV(1));
+            out.put((int32_t)std::min(u,w));
+            out.put((int32_t)std::max(u,w));
+            put_fields(edge_fields,mesh.edge_id(t,pos));
+        }
+    }
+
+    out.flush();
+    return !out.fail();
+}
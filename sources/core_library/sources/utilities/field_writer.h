@@ -0,0 +1,99 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIELD_WRITER_H
+#define FIELD_WRITER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <cstdio>
+
+#include "ia/mesh.h"
+
+using namespace std;
+
+/**
+ * @brief The Field_Writer class writes the mesh together with the scalar fields computed on its
+ * vertices, triangles and edges, in a binary (little-endian) PLY file
+ *
+ * The file contains the vertex element (coordinates followed by the vertex fields), the face element
+ * (vertex indices followed by the triangle fields) and, if an edge field is added, an edge element
+ * (the indices of the two extreme vertices followed by the edge fields).
+ * The vertices and the triangles are written in their input order (see Mesh::permute), and the edges following
+ * the input order of the triangles, thus the file matches the input mesh also when the mesh has been reordered.
+ * The fields are not copied: the arrays must be alive until the file is written.
+ */
+class Field_Writer
+{
+public:
+    Field_Writer() {}
+
+    ///A public method that adds a field of real values, one for each vertex of the mesh
+    inline void add_vertex_field(string name, const dvect &values) { vertex_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of 8-bit values (e.g., a classification), one for each vertex of the mesh
+    inline void add_vertex_field(string name, const vector<uint8_t> &values) { vertex_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of integer values (e.g., a region label), one for each vertex of the mesh
+    inline void add_vertex_field(string name, const ivect &values) { vertex_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of real values, one for each triangle of the mesh
+    inline void add_triangle_field(string name, const dvect &values) { triangle_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of 8-bit values, one for each triangle of the mesh
+    inline void add_triangle_field(string name, const vector<uint8_t> &values) { triangle_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of integer values, one for each triangle of the mesh
+    inline void add_triangle_field(string name, const ivect &values) { triangle_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of real values, one for each edge of the mesh (indexed by the edge index, see Mesh::EV)
+    inline void add_edge_field(string name, const dvect &values) { edge_fields.push_back(Field(name,values.data())); }
+    ///A public method that adds a field of 8-bit values, one for each edge of the mesh
+    inline void add_edge_field(string name, const vector<uint8_t> &values) { edge_fields.push_back(Field(name,values.data())); }
+
+    /**
+     * @brief A public method that writes the mesh and the fields
+     * The file is written through a large buffer, in a single pass on each element.
+     *
+     * @param mesh the mesh the fields are computed on
+     * @param path the path of the PLY file
+     * @return true if the file is correctly written, false otherwise
+     */
+    bool write_ply(Spatial_Mesh &mesh, string path);
+    ///A public method that writes the mesh and the fields in an open file (e.g., a temporary file), left open
+    bool write_ply(Spatial_Mesh &mesh, FILE *file);
+
+private:
+    ///A private struct representing a named field, either of doubles, of bytes or of integers (written as 32-bit values)
+    struct Field
+    {
+        string name;
+        const coord_type *reals;
+        const uint8_t *bytes;
+        const itype *ints;
+
+        Field(string n, const coord_type *r) : name(n), reals(r), bytes(NULL), ints(NULL) {}
+        Field(string n, const uint8_t *b) : name(n), reals(NULL), bytes(b), ints(NULL) {}
+        Field(string n, const itype *i) : name(n), reals(NULL), bytes(NULL), ints(i) {}
+    };
+
+    vector<Field> vertex_fields, triangle_fields, edge_fields;
+};
+
+#endif // FIELD_WRITER_H
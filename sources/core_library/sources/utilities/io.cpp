@@ -23,6 +23,27 @@
 
 #include "io.h"
 #include "utilities/string_management.h"
+#include "utilities/memory_map.h"
+#include "utilities/number_parsing.h"
+#include "utilities/parallel.h"
+#include "utilities/timer.h"
+
+#include <cstring>
+#include <limits>
+
+// the vertices are stored (and mapped) as packed coordinates
+static_assert(sizeof(Vertex) == 3*sizeof(coord_type), "Vertex must contain only the coordinates");
+
+static inline bool is_little_endian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const char*>(&one) == 1;
+}
+
+static inline size_t align_offset(size_t offset)
+{
+    return (offset + BINARY_MESH_ALIGNMENT - 1) / BINARY_MESH_ALIGNMENT * BINARY_MESH_ALIGNMENT;
+}
 
 bool IO::read_mesh(Spatial_Mesh &mesh, string path)
 {
@@ -31,6 +52,8 @@ bool IO::read_mesh(Spatial_Mesh &mesh, string path)
         return IO::read_mesh_tri(mesh,path);
     else if(extension == "off")
         return IO::read_mesh_off(mesh,path);
+    else if(extension == "ia_mesh")
+        return IO::read_mesh_binary(mesh,path);
     else
     {
         cerr << "[ERROR] unsopported file format. " << endl;
@@ -38,152 +61,560 @@ bool IO::read_mesh(Spatial_Mesh &mesh, string path)
     }
 }
 
-bool IO::read_mesh_off(Spatial_Mesh &mesh, string path)
+static inline const char* next_line(const char *p, const char *end)
 {
-    ifstream input(path.c_str());
+    const char *nl = static_cast<const char*>(memchr(p,'\n',end-p));
+    return (nl == NULL) ? end : nl+1;
+}
+
+static inline bool is_blank_line(const char *p, const char *line_end)
+{
+    p = number_parsing::skip_blanks(p,line_end);
+    return p == line_end || *p == '\n';
+}
+
+static inline void print_parsing_time(Timer &time, string path, size_t bytes)
+{
+    double mb = bytes/(1024.0*1024.0);
+    cerr << "[TIME] parsing " << path << " (" << mb << " MBs): " << time.get_elapsed_time() << " ("
+         << mb/time.get_elapsed_time() << " MB/s)" << endl;
+}
 
-    if (input.is_open() == false) {
+bool IO::read_mesh_off(Spatial_Mesh &mesh, string path)
+{
+    Timer time;
+    time.start();
+    Memory_Map map;
+    if (map.open(path) == false) {
         cerr << "Error in file " << path << "\nThe file could not exist, be unreadable or incorrect." << endl;
         return false;
     }
 
-    string l;
-    getline(input,l); // trow away the first line
-    getline(input,l);
-    vector<string> lt;
-    string_management::tokenize(l,lt," ");
-    itype num_vertices = atol(lt.at(0).c_str());
-    itype num_triangles = atol(lt.at(1).c_str());
+    const char *p = map.data(), *end = map.data()+map.size();
+    p = next_line(p,end); // trow away the first line
+    itype num_vertices = 0, num_triangles = 0;
+    const char *num = number_parsing::parse_integer(p,end,num_vertices);
+    if(num != NULL)
+        num = number_parsing::parse_integer(num,end,num_triangles);
 
-    if (num_vertices == 0 || num_triangles == 0)
+    if (num == NULL || num_vertices == 0 || num_triangles == 0 ||
+            !IO::parse_simplices_lists(mesh,next_line(p,end),end,num_vertices,num_triangles,true))
     {
         cerr << "This is not a valid .off file: " << path << endl;
         return false;
     }
 
-    mesh.reserve(num_vertices, num_triangles);
+    time.stop();
+    print_parsing_time(time,path,map.size());
+    return true;
+}
 
-    IO::read_vertices_list(mesh,input,num_vertices);
+bool IO::read_mesh_tri(Spatial_Mesh& mesh, string path)
+{
+    Timer time;
+    time.start();
+    Memory_Map map;
+    if (map.open(path) == false) {
+        cerr << "Error in file " << path << "\nThe file could not exist, be unreadable or incorrect." << endl;
+        return false;
+    }
 
-    itype v[3], index;
-    itype num_v;
-    for (itype i = 0; i < num_triangles; i++)
+    const char *p = map.data(), *end = map.data()+map.size();
+    itype num_vertices = 0;
+    if (number_parsing::parse_integer(p,end,num_vertices) == NULL || num_vertices == 0 ||
+            !IO::parse_simplices_lists(mesh,next_line(p,end),end,num_vertices,-1,false))
     {
-        input >> num_v;
+        cerr << "This is not a valid .tri file: " << path << endl;
+        return false;
+    }
+
+    time.stop();
+    print_parsing_time(time,path,map.size());
+    return true;
+}
 
-        if(num_v != 3)
+bool IO::parse_simplices_lists(Spatial_Mesh &mesh, const char *begin, const char *end,
+                               itype num_vertices, itype num_triangles, bool off_format)
+{
+    // line-aligned chunks
+    itype num_chunks = 4*parallel::get_threads_num();
+    vector<const char*> limits(num_chunks+1,end);
+    limits[0] = begin;
+    for(itype c=1; c<num_chunks; c++)
+    {
+        const char *p = begin + (end-begin)*c/num_chunks;
+        limits[c] = (p > limits[c-1]) ? next_line(p-1,end) : limits[c-1];
+    }
+
+    // first pass: the non-blank lines of each chunk
+    ivect first_line(num_chunks+1,0);
+    #pragma omp parallel for schedule(dynamic,1)
+    for(itype c=0; c<num_chunks; c++)
+    {
+        itype lines = 0;
+        for(const char *p = limits[c]; p < limits[c+1]; p = next_line(p,limits[c+1]))
         {
-            cerr << "[ERROR] the input mesh must be a pure triangle mesh. read a simplex with "<< num_v << "vertices." << endl;
-            return false;
+            if(!is_blank_line(p,limits[c+1]))
+                lines++;
         }
+        first_line[c+1] = lines;
+    }
+    for(itype c=0; c<num_chunks; c++)
+        first_line[c+1] += first_line[c];
+
+    // in the tri format the line after the vertices contains the number of triangles
+    itype triangles_line = (num_triangles == -1) ? num_vertices : -1;
+    itype first_triangle_line = (num_triangles == -1) ? num_vertices+1 : num_vertices;
+    if(num_triangles == -1)
+        num_triangles = first_line[num_chunks] - first_triangle_line;
+    if(num_triangles <= 0 || first_line[num_chunks] < first_triangle_line + num_triangles)
+        return false;
+
+    mesh.resize(num_vertices,num_triangles);
 
-        for (itype j = 0; j < num_v; j++)
+    // second pass: each line is parsed in its final position
+    bool valid = true, is2D = false;
+    #pragma omp parallel for schedule(dynamic,1) reduction(&&:valid) reduction(||:is2D)
+    for(itype c=0; c<num_chunks; c++)
+    {
+        itype line = first_line[c];
+        for(const char *p = limits[c]; p < limits[c+1] && valid; p = next_line(p,limits[c+1]))
         {
-            input >> index;
-            v[j] = index;
+            if(is_blank_line(p,limits[c+1]))
+                continue;
+
+            if(line < num_vertices)
+            {
+                coord_type coords[3] = {0,0,0};
+                int num_coords = 0;
+                const char *q = p;
+                while(num_coords < 3 && (q = number_parsing::parse_double(q,limits[c+1],coords[num_coords])) != NULL)
+                    num_coords++;
+                if(num_coords == 2)
+                    is2D = true;
+                else if(num_coords != 3)
+                    valid = false;
+                mesh.get_vertex(line) = Vertex(coords[0],coords[1],coords[2]);
+            }
+            else if(line == triangles_line)
+            {
+                itype num;
+                valid = (number_parsing::parse_integer(p,limits[c+1],num) != NULL && num == num_triangles);
+            }
+            else if(line < first_triangle_line + num_triangles)
+            {
+                itype v[3], num_v = 3;
+                const char *q = p;
+                if(off_format)
+                    q = number_parsing::parse_integer(q,limits[c+1],num_v);
+                if(num_v != 3)
+                {
+                    cerr << "[ERROR] the input mesh must be a pure triangle mesh. read a simplex with "<< num_v << "vertices." << endl;
+                    valid = false;
+                }
+                for(int j=0; j<3 && q != NULL; j++)
+                    q = number_parsing::parse_integer(q,limits[c+1],v[j]);
+                if(q == NULL || v[0] < 0 || v[0] >= num_vertices || v[1] < 0 || v[1] >= num_vertices ||
+                        v[2] < 0 || v[2] >= num_vertices)
+                    valid = false;
+                else
+                    mesh.set_triangle(line-first_triangle_line,v[0],v[1],v[2]);
+            }
+            line++;
         }
-        Triangle t = Triangle(v[0], v[1], v[2]);
-        mesh.add_triangle(t);
     }
 
+    if(!valid)
+    {
+        mesh.resize(0,0);
+        return false;
+    }
+
+    if(is2D)
+        cerr<<"[NOTA] The points are embedded in a 2D space."<<endl;
+    else
+        cerr<<"[NOTA] The points are embedded in a 3D space."<<endl;
     return true;
 }
 
-bool IO::read_mesh_tri(Spatial_Mesh& mesh, string path)
+void IO::get_input_order_connectivity(Spatial_Mesh& mesh, ivect &vtstar, ivect &tt)
 {
-    ifstream input(path.c_str());
+    itype num_v = mesh.get_vertices_num(), num_t = mesh.get_triangles_num();
+    const itype *mesh_vtstar = mesh.get_VTstar_array(), *mesh_tt = mesh.get_TT_array();
+    vtstar.resize(num_v);
+    tt.resize(3*num_t);
 
-    if (input.is_open() == false) {
-        cerr << "Error in file " << path << "\nThe file could not exist, be unreadable or incorrect." << endl;
-        return false;
+    for(itype v=0; v<num_v; v++)
+    {
+        itype t = mesh_vtstar[v];
+        vtstar[mesh.get_original_vertex_id(v)] = (t == -1) ? t : mesh.get_original_triangle_id(t);
     }
+    for(itype t=0; t<num_t; t++)
+    {
+        itype ot = mesh.get_original_triangle_id(t);
+        for(int i=0; i<3; i++)
+        {
+            itype adj = mesh_tt[3*t+i];
+            tt[3*ot+i] = (adj == -1) ? adj : mesh.get_original_triangle_id(adj);
+        }
+    }
+}
 
-    string l;
-    getline(input,l);
-    vector<string> lt;
-    string_management::tokenize(l,lt," ");
-    itype num_vertices = atoi(lt.at(0).c_str());
+#define FNV_PRIME 1099511628211ULL
+#define FNV_OFFSET 14695981039346656037ULL
+// number of vertices (or triangles) hashed by each block of the fingerprint
+#define FINGERPRINT_BLOCK 16384
 
-    if (num_vertices == 0)
+// FNV-1a on 64-bit words
+static inline void fnv_add(uint64_t &hash, uint64_t word)
+{
+    hash ^= word;
+    hash *= FNV_PRIME;
+}
+
+// hashes the elements [0,num) in blocks of FINGERPRINT_BLOCK elements, in parallel, and adds the hashes of the
+// blocks, in order, to hash (the result does not depend on the number of threads)
+template<class F> static void fnv_add_blocks(uint64_t &hash, itype num, F add_element)
+{
+    itype blocks = (num + FINGERPRINT_BLOCK - 1) / FINGERPRINT_BLOCK;
+    vector<uint64_t> block_hash(blocks,FNV_OFFSET);
+    #pragma omp parallel for schedule(static)
+    for(itype b=0; b<blocks; b++)
     {
-        cerr << "This is not a valid .tri file: " << path << endl;
+        itype last = std::min(num,(b+1)*FINGERPRINT_BLOCK);
+        for(itype i=b*FINGERPRINT_BLOCK; i<last; i++)
+            add_element(block_hash[b],i);
+    }
+    for(itype b=0; b<blocks; b++)
+        fnv_add(hash,block_hash[b]);
+}
+
+uint64_t IO::mesh_fingerprint(Spatial_Mesh& mesh)
+{
+    uint64_t hash = FNV_OFFSET;
+    itype num_v = mesh.get_vertices_num(), num_t = mesh.get_triangles_num();
+    fnv_add(hash,num_v);
+    fnv_add(hash,num_t);
+
+    ivect v_position, t_position;
+    if(mesh.has_original_ids())
+    {
+        v_position.resize(num_v);
+        t_position.resize(num_t);
+        #pragma omp parallel for schedule(static)
+        for(itype v=0; v<num_v; v++)
+            v_position[mesh.get_original_vertex_id(v)] = v;
+        #pragma omp parallel for schedule(static)
+        for(itype t=0; t<num_t; t++)
+            t_position[mesh.get_original_triangle_id(t)] = t;
+    }
+
+    fnv_add_blocks(hash,num_v,[&mesh,&v_position](uint64_t &block, itype v)
+    {
+        Vertex &vert = mesh.get_vertex(v_position.empty() ? v : v_position[v]);
+        for(int c=0; c<3; c++)
+        {
+            coord_type coord = vert.get_c(c);
+            uint64_t word = 0;
+            memcpy(&word,&coord,sizeof(coord));
+            fnv_add(block,word);
+        }
+    });
+    fnv_add_blocks(hash,num_t,[&mesh,&t_position](uint64_t &block, itype t)
+    {
+        Triangle tri = mesh.get_triangle(t_position.empty() ? t : t_position[t]);
+        for(int i=0; i<3; i++)
+            fnv_add(block,mesh.get_original_vertex_id(tri.TV(i)));
+    });
+    return hash;
+}
+
+bool IO::write_mesh_connectivity(Spatial_Mesh& mesh, string path)
+{
+    // if the mesh has been reordered, the connectivity is written following the input order
+    ivect input_vtstar, input_tt;
+    const itype *vtstar = mesh.get_VTstar_array(), *tt = mesh.get_TT_array();
+    if(mesh.has_original_ids())
+    {
+        IO::get_input_order_connectivity(mesh,input_vtstar,input_tt);
+        vtstar = &input_vtstar[0];
+        tt = &input_tt[0];
+    }
+    uint64_t fingerprint = IO::mesh_fingerprint(mesh);
+
+    stringstream ss; ss<<path<<".ia_conn";
+    ofstream output(ss.str().c_str());
+
+    output<<"IA_CONNECTIVITY"<<endl;
+    output<<mesh.get_vertices_num()<<" 1 0,2,"<<mesh.get_triangles_num()<<endl;
+    for(itype v=0; v<mesh.get_vertices_num(); v++)
+        output<<"2,"<<vtstar[v]<<endl;
+    for(itype t=0; t<mesh.get_triangles_num(); t++)
+        output<<tt[3*t]<<" "<<tt[3*t+1]<<" "<<tt[3*t+2]<<endl;
+    output<<"0"<<endl; /// for non-manifold adjacencies
+    output<<"FINGERPRINT "<<fingerprint<<endl;
+    output.close();
+
+    if(!is_little_endian())
+        return !output.fail();
+
+    stringstream ss_bin; ss_bin<<path<<".ia_conn_bin";
+    ofstream output_bin(ss_bin.str().c_str(), ios::binary);
+
+    Binary_Connectivity_Header header;
+    memset(&header,0,sizeof(header));
+    strncpy(header.magic,"IA_CONN",8);
+    header.version = BINARY_MESH_VERSION;
+    header.index_bytes = sizeof(itype);
+    header.num_vertices = mesh.get_vertices_num();
+    header.num_triangles = mesh.get_triangles_num();
+    header.fingerprint = fingerprint;
+
+    const char zeros[BINARY_MESH_ALIGNMENT] = {0};
+    size_t vtstar_offset = align_offset(sizeof(header));
+    size_t tt_offset = align_offset(vtstar_offset + mesh.get_vertices_num()*sizeof(itype));
+    output_bin.write(reinterpret_cast<const char*>(&header),sizeof(header));
+    output_bin.write(zeros,vtstar_offset-sizeof(header));
+    output_bin.write(reinterpret_cast<const char*>(vtstar),mesh.get_vertices_num()*sizeof(itype));
+    output_bin.write(zeros,tt_offset-(vtstar_offset + mesh.get_vertices_num()*sizeof(itype)));
+    output_bin.write(reinterpret_cast<const char*>(tt),3*mesh.get_triangles_num()*sizeof(itype));
+    output_bin.close();
+
+    return !output.fail() && !output_bin.fail();
+}
+
+// the fingerprint of the mesh, computed on the first call (0 stands for not computed yet), so that only a
+// connectivity file with a valid header costs the pass over the mesh
+static uint64_t get_fingerprint(Spatial_Mesh& mesh, uint64_t &fingerprint)
+{
+    if(fingerprint == 0)
+        fingerprint = IO::mesh_fingerprint(mesh);
+    return fingerprint;
+}
+
+bool IO::read_mesh_connectivity(Spatial_Mesh& mesh, string path)
+{
+    uint64_t fingerprint = 0;
+    if(is_little_endian() && IO::read_connectivity_binary(mesh,path+".ia_conn_bin",fingerprint))
+        return true;
+    return IO::read_connectivity_ascii(mesh,path+".ia_conn",fingerprint);
+}
+
+// true if all the num values are in [min,max)
+static bool indices_in_range(const itype *values, itype num, itype min, itype max)
+{
+    itype invalid = 0;
+    #pragma omp parallel for schedule(static) reduction(+:invalid)
+    for(itype i=0; i<num; i++)
+    {
+        if(values[i] < min || values[i] >= max)
+            invalid++;
+    }
+    return invalid == 0;
+}
+
+bool IO::read_connectivity_binary(Spatial_Mesh& mesh, string path, uint64_t &fingerprint)
+{
+    shared_ptr<Memory_Map> map = make_shared<Memory_Map>();
+    if(!map->open(path))
+        return false;
+
+    Binary_Connectivity_Header header;
+    if(map->size() < sizeof(header))
+        return false;
+    memcpy(&header,map->data(),sizeof(header));
+
+    size_t vtstar_offset = align_offset(sizeof(header));
+    size_t tt_offset = align_offset(vtstar_offset + mesh.get_vertices_num()*sizeof(itype));
+    if(strncmp(header.magic,"IA_CONN",8) != 0 || header.version != BINARY_MESH_VERSION ||
+            header.index_bytes != sizeof(itype) ||
+            map->size() < tt_offset + 3*mesh.get_triangles_num()*sizeof(itype))
+    {
+        cerr << "[NOTA] " << path << " is not a valid connectivity file." << endl;
+        return false;
+    }
+    if(header.num_vertices != (uint64_t)mesh.get_vertices_num() ||
+            header.num_triangles != (uint64_t)mesh.get_triangles_num() || header.fingerprint != get_fingerprint(mesh,fingerprint))
+    {
+        cerr << "[NOTA] " << path << " has been computed on a different mesh." << endl;
+        return false;
+    }
+    const char *data = static_cast<const char*>(map->data());
+    if(!indices_in_range(reinterpret_cast<const itype*>(data+vtstar_offset),mesh.get_vertices_num(),-1,mesh.get_triangles_num()) ||
+            !indices_in_range(reinterpret_cast<const itype*>(data+tt_offset),3*mesh.get_triangles_num(),-1,mesh.get_triangles_num()))
+    {
+        cerr << "[NOTA] " << path << " is not a valid connectivity file (indices out of range)." << endl;
         return false;
     }
 
-    mesh.reserve_vertices_space(num_vertices);
+    mesh.map_connectivity(map,vtstar_offset,tt_offset);
+    return true;
+}
 
-    IO::read_vertices_list(mesh,input,num_vertices);
+bool IO::read_connectivity_ascii(Spatial_Mesh& mesh, string path, uint64_t &fingerprint)
+{
+    ifstream input(path.c_str());
+    if (input.is_open() == false)
+        return false;
 
-    itype num_triangles;
-    input >> num_triangles;
+    string l;
+    getline(input,l);
+    if(l != "IA_CONNECTIVITY")
+    {
+        cerr << "[NOTA] " << path << " is not a valid connectivity file." << endl;
+        return false;
+    }
 
-    if (num_triangles == 0)
+    // header line: num_vertices 1 0,2,num_triangles
+    itype num_vertices = -1, num_triangles = -1;
+    char sep;
+    int dummy;
+    input >> num_vertices >> dummy >> dummy >> sep >> dummy >> sep >> num_triangles;
+    if(input.fail() || num_vertices != mesh.get_vertices_num() || num_triangles != mesh.get_triangles_num())
     {
-        cerr << "This is not a valid .tri file: " << path << endl;
+        cerr << "[NOTA] " << path << " has been computed on a different mesh." << endl;
         return false;
     }
 
-    mesh.reserve_triangles_space(num_triangles);
+    ivect vtstar(num_vertices), tt(3*num_triangles);
+    for(itype v=0; v<num_vertices; v++)
+        input >> dummy >> sep >> vtstar[v];
+    for(itype i=0; i<3*num_triangles; i++)
+        input >> tt[i];
 
-    itype v[3], index;
-    for (itype i = 0; i < num_triangles; i++)
+    string tag;
+    uint64_t file_fingerprint = 0;
+    input >> dummy >> tag >> file_fingerprint; /// the non-manifold adjacencies are not used
+    if(input.fail() || tag != "FINGERPRINT" || file_fingerprint != get_fingerprint(mesh,fingerprint))
     {
-        for (int j = 0; j < 3; j++) {
-            input >> index;
-            v[j] = index;
-        }
-        Triangle t = Triangle(v[0], v[1], v[2]);
-        mesh.add_triangle(t);
+        cerr << "[NOTA] " << path << " has been computed on a different mesh (or has no fingerprint)." << endl;
+        return false;
     }
 
+    mesh.set_connectivity(vtstar,tt);
     return true;
 }
 
-void IO::read_vertices_list(Spatial_Mesh &mesh, ifstream &input, itype num_vertices)
+bool IO::read_mesh_binary(Spatial_Mesh& mesh, string path)
 {
-    bool is2D = false;
-    string line;
-    //legge i vertici aggiustando il dominio..
-    for (itype i = 0; i < num_vertices; i++)
+    if(!is_little_endian())
     {
-        getline(input,line);
-        vector<string> line_tokens;
-        string_management::tokenize(line,line_tokens," ");
+        cerr << "[ERROR] the binary mesh format is supported only on little-endian systems." << endl;
+        return false;
+    }
 
-        if (input.eof())
-            break;
-        Vertex v;
-        if(line_tokens.size() == 3) // 3D
-            v = Vertex(atof(line_tokens[0].c_str()),atof(line_tokens[1].c_str()),atof(line_tokens[2].c_str()));
-        else if(line_tokens.size() == 2) // 2D
-        {
-            v = Vertex(atof(line_tokens[0].c_str()),atof(line_tokens[1].c_str()));
-            is2D = true;
-        }
-        mesh.add_vertex(v);
+    shared_ptr<Memory_Map> map = make_shared<Memory_Map>();
+    if(!map->open(path))
+    {
+        cerr << "Error in file " << path << "\nThe file could not exist, be unreadable or incorrect." << endl;
+        return false;
     }
 
-    if(is2D)
-        cerr<<"[NOTA] The points are embedded in a 2D space."<<endl;
-    else
-        cerr<<"[NOTA] The points are embedded in a 3D space."<<endl;
+    Binary_Mesh_Header header;
+    if(map->size() < sizeof(header))
+    {
+        cerr << "This is not a valid .ia_mesh file: " << path << endl;
+        return false;
+    }
+    memcpy(&header,map->data(),sizeof(header));
+    if(strncmp(header.magic,"IA_MESH",8) != 0 || header.version != BINARY_MESH_VERSION)
+    {
+        cerr << "This is not a valid .ia_mesh file (or version): " << path << endl;
+        return false;
+    }
+    if(header.index_bytes != sizeof(itype) || header.coord_bytes != sizeof(coord_type))
+    {
+        cerr << "[ERROR] " << path << " has been written with " << header.index_bytes << " bytes indices and "
+             << header.coord_bytes << " bytes coordinates." << endl;
+        return false;
+    }
+
+    // the counts must fit in itype (also the 3*num_triangles entries of TV and TT) and in the file, before computing the offsets
+    if(header.num_vertices == 0 || header.num_triangles == 0 ||
+            header.num_vertices > (uint64_t)numeric_limits<itype>::max() || header.num_triangles > (uint64_t)numeric_limits<itype>::max()/3 ||
+            header.num_vertices > map->size()/sizeof(Vertex) || header.num_triangles > map->size()/(3*sizeof(itype)))
+    {
+        cerr << "This is not a valid .ia_mesh file: " << path << endl;
+        return false;
+    }
+    itype num_vertices = header.num_vertices;
+    itype num_triangles = header.num_triangles;
+    size_t vertices_offset = align_offset(sizeof(header));
+    size_t tv_offset = align_offset(vertices_offset + num_vertices*sizeof(Vertex));
+    size_t end = tv_offset + 3*num_triangles*sizeof(itype);
+    size_t vtstar_offset = align_offset(end);
+    size_t tt_offset = align_offset(vtstar_offset + num_vertices*sizeof(itype));
+    if(header.flags & BINARY_MESH_CONNECTIVITY)
+        end = tt_offset + 3*num_triangles*sizeof(itype);
+
+    if (map->size() < end)
+    {
+        cerr << "This is not a valid .ia_mesh file: " << path << endl;
+        return false;
+    }
+
+    // the arrays are used without copies, thus their indices are checked once (as the ASCII parser does)
+    const char *data = static_cast<const char*>(map->data());
+    bool valid = indices_in_range(reinterpret_cast<const itype*>(data+tv_offset),3*num_triangles,0,num_vertices);
+    if(valid && (header.flags & BINARY_MESH_CONNECTIVITY))
+        valid = indices_in_range(reinterpret_cast<const itype*>(data+vtstar_offset),num_vertices,-1,num_triangles) &&
+                indices_in_range(reinterpret_cast<const itype*>(data+tt_offset),3*num_triangles,-1,num_triangles);
+    if(!valid)
+    {
+        cerr << "This is not a valid .ia_mesh file (indices out of range): " << path << endl;
+        return false;
+    }
+
+    mesh.map_arrays(map,vertices_offset,num_vertices,tv_offset,num_triangles);
+    if(header.flags & BINARY_MESH_CONNECTIVITY)
+        mesh.map_connectivity(map,vtstar_offset,tt_offset);
+
+    return true;
 }
 
-bool IO::write_mesh_connectivity(Spatial_Mesh& mesh, string path)
+bool IO::write_mesh_binary(Spatial_Mesh& mesh, string path)
 {
-    stringstream ss; ss<<path<<".ia_conn";
-    ofstream output(ss.str().c_str());
+    if(!is_little_endian())
+    {
+        cerr << "[ERROR] the binary mesh format is supported only on little-endian systems." << endl;
+        return false;
+    }
 
-    output<<"IA_CONNECTIVITY"<<endl;
-    output<<mesh.get_vertices_num()<<" 1 0,2,"<<mesh.get_triangles_num()<<endl;
-    for(itype v=0; v<mesh.get_vertices_num(); v++)
-        output<<"2,"<<mesh.get_vertex(v).get_VTstar()<<endl;
-    for(itype t=0; t<mesh.get_triangles_num(); t++)
+    stringstream ss; ss<<path<<".ia_mesh";
+    ofstream output(ss.str().c_str(), ios::binary);
+    if(!output.is_open())
+        return false;
+
+    Binary_Mesh_Header header;
+    memset(&header,0,sizeof(header));
+    strncpy(header.magic,"IA_MESH",8);
+    header.version = BINARY_MESH_VERSION;
+    header.flags = (mesh.is_built()) ? BINARY_MESH_CONNECTIVITY : 0;
+    header.index_bytes = sizeof(itype);
+    header.coord_bytes = sizeof(coord_type);
+    header.num_vertices = mesh.get_vertices_num();
+    header.num_triangles = mesh.get_triangles_num();
+
+    size_t offset = 0;
+    const char zeros[BINARY_MESH_ALIGNMENT] = {0};
+    // writes an array, preceded by the padding that aligns it
+    auto write_array = [&](const void *data, size_t bytes)
+    {
+        size_t aligned = align_offset(offset);
+        output.write(zeros,aligned-offset);
+        output.write(static_cast<const char*>(data),bytes);
+        offset = aligned + bytes;
+    };
+
+    write_array(&header,sizeof(header));
+    write_array(mesh.get_vertices_array(),mesh.get_vertices_num()*sizeof(Vertex));
+    write_array(mesh.get_TV_array(),3*mesh.get_triangles_num()*sizeof(itype));
+    if(mesh.is_built())
     {
-        Triangle &tri = mesh.get_triangle(t);
-        output<<tri.TT(0)<<" "<<tri.TT(1)<<" "<<tri.TT(2)<<endl;
+        write_array(mesh.get_VTstar_array(),mesh.get_vertices_num()*sizeof(itype));
+        write_array(mesh.get_TT_array(),3*mesh.get_triangles_num()*sizeof(itype));
     }
-    output<<"0"<<endl; /// for non-manifold adjacencies
+
     output.close();
-    return true;
+    return !output.fail();
 }
@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <stdint.h>
 
 #include "ia/vt_star.h"
 #include "ia/vertex.h"
@@ -38,6 +39,36 @@
 #include "ia/triangle.h"
 
 using namespace std;
+
+///The header of the binary mesh format (.ia_mesh), stored little-endian
+struct Binary_Mesh_Header
+{
+    char magic[8]; // "IA_MESH"
+    uint32_t version;
+    uint32_t flags; // BINARY_MESH_CONNECTIVITY if VTstar and TT are stored
+    uint32_t index_bytes; // sizeof(itype) of the writer
+    uint32_t coord_bytes; // sizeof(coord_type) of the writer
+    uint64_t num_vertices;
+    uint64_t num_triangles;
+    uint64_t reserved[3];
+};
+
+///The header of the binary connectivity format (.ia_conn_bin), stored little-endian
+struct Binary_Connectivity_Header
+{
+    char magic[8]; // "IA_CONN"
+    uint32_t version;
+    uint32_t index_bytes; // sizeof(itype) of the writer
+    uint64_t num_vertices;
+    uint64_t num_triangles;
+    uint64_t fingerprint; // see IO::mesh_fingerprint
+    uint64_t reserved[3];
+};
+
+#define BINARY_MESH_VERSION 1
+#define BINARY_MESH_CONNECTIVITY 1u
+#define BINARY_MESH_ALIGNMENT 64
+
 ///A class that handles the input/output to initialize the main library structures
 class IO {
 public:
@@ -49,7 +80,41 @@ public:
      */
     static bool read_mesh(Spatial_Mesh& mesh, string path);
 
+    ///A public method that writes the VTstar and TT relations of the mesh in the ASCII (.ia_conn) and binary (.ia_conn_bin) formats
+    /*!
+     * Both files contain the fingerprint of the mesh (see mesh_fingerprint) and, if the mesh
+     * has been reordered, the relations are written following the input order.
+     * \param mesh a Mesh& argument, representing the mesh to write
+     * \param path a string argument, representing the path of the files (without extension)
+     * \return a boolean value, true if the files are correctly written, false otherwise
+     */
     static bool write_mesh_connectivity(Spatial_Mesh& mesh, string path);
+    ///A public method that reads the VTstar and TT relations of the mesh, previously saved by write_mesh_connectivity
+    /*!
+     * The binary file (.ia_conn_bin) is memory-mapped and preferred to the ASCII one (.ia_conn).
+     * A file is accepted only if its fingerprint matches the one of the mesh,
+     * and in this case the mesh is built. The fingerprint is computed only if a file with a valid header is found.
+     * \param mesh a Mesh& argument, representing the mesh (vertices and TV relation already initialized)
+     * \param path a string argument, representing the path of the files (without extension)
+     * \return a boolean value, true if the connectivity is loaded, false otherwise
+     */
+    static bool read_mesh_connectivity(Spatial_Mesh& mesh, string path);
+    ///A public method that returns a fingerprint of the vertices coordinates and of the TV relation
+    /*!
+     * The coordinates and the TV entries (in the input order) are hashed with the 64-bit FNV-1a in fixed-size blocks,
+     * in parallel, and the fingerprint is the FNV-1a hash of the counts and of the block hashes.
+     * It ties a connectivity file to the mesh it has been computed on.
+     */
+    static uint64_t mesh_fingerprint(Spatial_Mesh& mesh);
+    ///A public method that writes the mesh in the binary format (.ia_mesh)
+    /*!
+     * The file is little-endian and contains a header followed by the vertices coordinates, the TV relation
+     * and, if the mesh is built, the VTstar and TT relations (each array is aligned to 64 bytes).
+     * \param mesh a Mesh& argument, representing the mesh to write
+     * \param path a string argument, representing the path of the file (without extension)
+     * \return a boolean value, true if the file is correctly written, false otherwise
+     */
+    static bool write_mesh_binary(Spatial_Mesh& mesh, string path);
 private:
     ///A constructor method
     IO() {}
@@ -72,16 +137,39 @@ private:
      * \return a boolean value, true if the file is correctly readed, false otherwise
      */
     static bool read_mesh_tri(Spatial_Mesh& mesh, string path);
+    ///A public method that maps a file containing a triangle mesh in the binary format (.ia_mesh)
+    /*!
+     * The arrays of the mesh are views of the mapped file (no copy), and if the file
+     * contains the VTstar and TT relations the mesh is already built.
+     * \param mesh a Mesh& argument, representing the mesh to initialize
+     * \param path a string argument, representing the path to the mesh file
+     * \return a boolean value, true if the file is correctly readed, false otherwise
+     */
+    static bool read_mesh_binary(Spatial_Mesh& mesh, string path);
+    ///A private method that maps the binary connectivity file (.ia_conn_bin)
+    /// (fingerprint is the one of the mesh, computed by the first reader that needs it, 0 until then)
+    static bool read_connectivity_binary(Spatial_Mesh& mesh, string path, uint64_t &fingerprint);
+    ///A private method that reads the ASCII connectivity file (.ia_conn)
+    static bool read_connectivity_ascii(Spatial_Mesh& mesh, string path, uint64_t &fingerprint);
+    ///A private method that returns the VTstar and TT relations following the input order of vertices and triangles
+    static void get_input_order_connectivity(Spatial_Mesh& mesh, ivect &vtstar, ivect &tt);
     /**
-     * @brief A private method that reads a list of vertices with just the coordinates
+     * @brief A private method that parses in parallel the lists of vertices and triangles of an ASCII mesh
+     * The buffer is split in line-aligned chunks: the non-blank lines of each chunk are counted first,
+     * then each chunk is parsed knowing the index of its first line, writing the vertices and the triangles
+     * directly in their final position in the mesh arrays.
      *
      * @param mesh represents the mesh to initialize
-     * @param input represents the input stream
+     * @param begin represents the first character after the header of the file
+     * @param end represents the end of the file
      * @param num_vertices represents the number of vertices of the mesh
-     *
-     * NOTA: the procedure also set the mesh domain
+     * @param num_triangles represents the number of triangles of the mesh, or -1 if the triangles list
+     * is preceded by a line containing it (tri format)
+     * @param off_format true if the triangles lines start with the number of vertices (off format)
+     * @return true if the lists are correctly parsed, false otherwise
      */
-    static void read_vertices_list(Spatial_Mesh& mesh, ifstream &input, itype num_vertices);
+    static bool parse_simplices_lists(Spatial_Mesh& mesh, const char *begin, const char *end,
+                                      itype num_vertices, itype num_triangles, bool off_format);
 };
 
 #endif	/* _IO_H */
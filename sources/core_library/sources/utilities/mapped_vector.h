@@ -0,0 +1,115 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MAPPED_VECTOR_H
+#define MAPPED_VECTOR_H
+
+#include <vector>
+#include <memory>
+
+#include "utilities/memory_map.h"
+
+using namespace std;
+
+/**
+ * @brief A vector-like array that either owns its elements or is a view of a region of a memory-mapped file
+ * A mapped array is read and written in place (the pages are private to the process),
+ * while any operation that changes its size first copies the elements in an owned vector.
+ * Copying a mapped array produces an owned array.
+ */
+template<class T> class Mapped_Vector
+{
+public:
+    Mapped_Vector() : ptr(NULL), num(0) {}
+    Mapped_Vector(const Mapped_Vector &orig) : owned(orig.begin(),orig.end()) { this->sync(); }
+    inline Mapped_Vector& operator=(const Mapped_Vector &orig)
+    {
+        if(this != &orig)
+        {
+            this->map.reset();
+            this->owned.assign(orig.begin(),orig.end());
+            this->sync();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief A public method that makes the array a view of num elements of a mapped file
+     *
+     * @param map the mapped file (kept alive by the array)
+     * @param offset the position (in bytes) of the first element in the file
+     * @param num the number of elements
+     */
+    inline void map_region(const shared_ptr<Memory_Map> &map, size_t offset, size_t num)
+    {
+        vector<T>().swap(this->owned);
+        this->map = map;
+        this->ptr = reinterpret_cast<T*>(map->data()+offset);
+        this->num = num;
+    }
+    inline bool is_mapped() const { return (bool)this->map; }
+
+    inline size_t size() const { return this->num; }
+    inline bool empty() const { return this->num == 0; }
+    /// the memory of a mapped array is the size of the region
+    inline size_t capacity() const { return (this->map) ? this->num : this->owned.capacity(); }
+
+    inline T& operator[](size_t pos) { return this->ptr[pos]; }
+    inline const T& operator[](size_t pos) const { return this->ptr[pos]; }
+    inline T* data() { return this->ptr; }
+    inline const T* data() const { return this->ptr; }
+    inline T* begin() { return this->ptr; }
+    inline T* end() { return this->ptr+this->num; }
+    inline const T* begin() const { return this->ptr; }
+    inline const T* end() const { return this->ptr+this->num; }
+
+    inline void push_back(const T &e) { this->detach(); this->owned.push_back(e); this->sync(); }
+    inline void reserve(size_t n) { this->detach(); this->owned.reserve(n); this->sync(); }
+    inline void resize(size_t n) { this->detach(); this->owned.resize(n); this->sync(); }
+    inline void assign(size_t n, const T &e) { this->map.reset(); this->owned.assign(n,e); this->sync(); }
+    inline void clear() { this->map.reset(); this->owned.clear(); this->sync(); }
+    inline void swap(vector<T> &v) { this->detach(); this->owned.swap(v); this->sync(); }
+
+private:
+    vector<T> owned;
+    shared_ptr<Memory_Map> map;
+    T *ptr;
+    size_t num;
+
+    /// copies the mapped elements in the owned vector
+    inline void detach()
+    {
+        if(this->map)
+        {
+            this->owned.assign(this->ptr,this->ptr+this->num);
+            this->map.reset();
+        }
+    }
+    inline void sync()
+    {
+        this->ptr = (this->owned.empty()) ? NULL : &this->owned[0];
+        this->num = this->owned.size();
+    }
+};
+
+#endif // MAPPED_VECTOR_H
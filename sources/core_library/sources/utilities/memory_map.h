@@ -0,0 +1,100 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORY_MAP_H
+#define MEMORY_MAP_H
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+
+using namespace std;
+
+/**
+ * @brief The Memory_Map class maps a whole file in memory (read-only file, private copy-on-write pages)
+ * The mapping is released when the object is destroyed.
+ */
+class Memory_Map
+{
+public:
+    Memory_Map() : ptr(NULL), num_bytes(0) {}
+    ~Memory_Map() { this->close(); }
+
+    /**
+     * @brief A public method that maps the file in memory
+     * The pages are mapped private, thus they can be modified without altering the file.
+     *
+     * @param path the path of the file
+     * @return true if the file is mapped, false otherwise
+     */
+    inline bool open(string path)
+    {
+        this->close();
+        int fd = ::open(path.c_str(),O_RDONLY);
+        if(fd == -1)
+            return false;
+        struct stat st;
+        if(fstat(fd,&st) == -1 || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(NULL,st.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,0);
+        ::close(fd);
+        if(p == MAP_FAILED)
+            return false;
+        this->ptr = static_cast<char*>(p);
+        this->num_bytes = st.st_size;
+        return true;
+    }
+    /**
+     * @brief A public method that releases the mapping
+     */
+    inline void close()
+    {
+        if(this->ptr != NULL)
+            munmap(this->ptr,this->num_bytes);
+        this->ptr = NULL;
+        this->num_bytes = 0;
+    }
+    /**
+     * @brief A public method that returns the first byte of the mapped file
+     */
+    inline char* data() { return this->ptr; }
+    /**
+     * @brief A public method that returns the size (in bytes) of the mapped file
+     */
+    inline size_t size() { return this->num_bytes; }
+
+private:
+    char *ptr;
+    size_t num_bytes;
+
+    Memory_Map(const Memory_Map&);
+    Memory_Map& operator=(const Memory_Map&);
+};
+
+#endif // MEMORY_MAP_H
@@ -0,0 +1,169 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NUMBER_PARSING_H
+#define NUMBER_PARSING_H
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "basic_wrappers.h"
+
+/**
+ * @brief A set of procedures that parse numbers from a (not null-terminated) character buffer
+ * without allocating memory. Each procedure skips the leading blanks (but not the newlines)
+ * and returns the position after the number, or NULL if no number is found.
+ */
+namespace number_parsing
+{
+
+inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char* skip_blanks(const char *p, const char *end)
+{
+    while(p < end && is_blank(*p))
+        p++;
+    return p;
+}
+
+/**
+ * @brief A procedure that parses a (signed) integer
+ */
+inline const char* parse_integer(const char *p, const char *end, itype &value)
+{
+    p = skip_blanks(p,end);
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if(p == end || !is_digit(*p))
+        return NULL;
+    itype v = 0;
+    while(p < end && is_digit(*p))
+        v = v*10 + (*p++ - '0');
+    value = (negative) ? -v : v;
+    return p;
+}
+
+/**
+ * @brief A procedure that parses a floating point number
+ * The numbers with at most 19 significant digits, a mantissa lower than 2^53 and a decimal exponent
+ * in [-22,22] are converted exactly with a single floating point operation (Clinger's fast path),
+ * while the others are converted by strtod. Thus, the result is always the one of strtod/atof.
+ */
+inline const char* parse_double(const char *p, const char *end, double &value)
+{
+    static const double powers_of_ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    p = skip_blanks(p,end);
+    const char *start = p;
+
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    uint64_t mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool truncated = false, found = false;
+    for(; p < end && is_digit(*p); p++)
+    {
+        found = true;
+        if(digits < 19)
+        {
+            mantissa = mantissa*10 + (*p - '0');
+            if(mantissa > 0)
+                digits++;
+        }
+        else
+        {
+            truncated = true;
+            exponent++;
+        }
+    }
+    if(p < end && *p == '.')
+    {
+        for(p++; p < end && is_digit(*p); p++)
+        {
+            found = true;
+            if(digits < 19)
+            {
+                mantissa = mantissa*10 + (*p - '0');
+                if(mantissa > 0)
+                    digits++;
+                exponent--;
+            }
+            else
+                truncated = true;
+        }
+    }
+    if(found && p < end && (*p == 'e' || *p == 'E'))
+    {
+        const char *e = p+1;
+        bool negative_exp = false;
+        if(e < end && (*e == '-' || *e == '+'))
+            negative_exp = (*e++ == '-');
+        if(e < end && is_digit(*e))
+        {
+            int exp_value = 0;
+            for(; e < end && is_digit(*e); e++)
+            {
+                if(exp_value < 100000)
+                    exp_value = exp_value*10 + (*e - '0');
+            }
+            exponent += (negative_exp) ? -exp_value : exp_value;
+            p = e;
+        }
+    }
+
+    if(found && !truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double v = (double)mantissa;
+        v = (exponent < 0) ? v / powers_of_ten[-exponent] : v * powers_of_ten[exponent];
+        value = (negative) ? -v : v;
+        return p;
+    }
+
+    // slow path (also for inf and nan): strtod on a null-terminated copy of the token
+    if(!found)
+    {
+        p = start;
+        while(p < end && !is_blank(*p) && *p != '\n')
+            p++;
+    }
+    char buffer[128];
+    size_t len = p - start;
+    if(len == 0 || len >= sizeof(buffer))
+        return NULL;
+    memcpy(buffer,start,len);
+    buffer[len] = '\0';
+    char *stop;
+    value = strtod(buffer,&stop);
+    if(stop == buffer)
+        return NULL;
+    return start + (stop - buffer);
+}
+
+}
+
+#endif // NUMBER_PARSING_H
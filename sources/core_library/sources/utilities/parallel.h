@@ -0,0 +1,181 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "basic_wrappers.h"
+
+/**
+ * @brief A set of procedures that wrap the (optional) OpenMP runtime.
+ * If the library is compiled without OpenMP support, all the procedures fall back to a single thread.
+ */
+namespace parallel
+{
+
+/**
+ * @brief A procedure that sets the number of threads used by the parallel sections
+ *
+ * @param num the number of threads (a value lower than 1 keeps the default of the runtime)
+ */
+inline void set_threads_num(int num)
+{
+#ifdef _OPENMP
+    if(num > 0)
+        omp_set_num_threads(num);
+#else
+    (void)num;
+#endif
+}
+/**
+ * @brief A procedure that returns the number of threads used by the parallel sections
+ *
+ * @return int
+ */
+inline int get_threads_num()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+/**
+ * @brief A procedure that returns the index of the calling thread inside a parallel section
+ *
+ * @return int
+ */
+inline int get_thread_id()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+/**
+ * @brief A procedure that atomically replaces the value of target with value,
+ * if target is unset (i.e., -1) or value is lower than target
+ *
+ * @param target the variable to update
+ * @param value the candidate value
+ */
+inline void atomic_min(itype &target, itype value)
+{
+#ifdef _OPENMP
+    itype current = __atomic_load_n(&target, __ATOMIC_RELAXED);
+    while((current == -1 || value < current) &&
+          !__atomic_compare_exchange_n(&target, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#else
+    if(target == -1 || value < target)
+        target = value;
+#endif
+}
+/**
+ * @brief A procedure that atomically reads a variable updated by other threads
+ *
+ * @param target the variable to read
+ * @return the value of target
+ */
+inline itype atomic_load(const itype &target)
+{
+#ifdef _OPENMP
+    return __atomic_load_n(&target, __ATOMIC_RELAXED);
+#else
+    return target;
+#endif
+}
+/**
+ * @brief A procedure that atomically replaces the value of target with value, if target is equal to expected
+ *
+ * @param target the variable to update
+ * @param expected the value that target must have
+ * @param value the new value
+ * @return true if target has been replaced
+ */
+inline bool compare_and_swap(itype &target, itype expected, itype value)
+{
+#ifdef _OPENMP
+    return __atomic_compare_exchange_n(&target, &expected, value, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#else
+    if(target != expected)
+        return false;
+    target = value;
+    return true;
+#endif
+}
+/**
+ * @brief A procedure that atomically adds value to target
+ *
+ * @param target the variable to update
+ * @param value the value to add (negative to subtract)
+ * @return the value of target before the addition
+ */
+inline itype fetch_add(itype &target, itype value)
+{
+#ifdef _OPENMP
+    return __atomic_fetch_add(&target, value, __ATOMIC_RELAXED);
+#else
+    itype previous = target;
+    target += value;
+    return previous;
+#endif
+}
+/**
+ * @brief A procedure that splits the ids in [0,num) in contiguous chunks with a similar total cost,
+ * so that a dynamic schedule over the chunks balances the work even if the cost of the ids is skewed
+ *
+ * @param cost the cost of each id
+ * @param chunks_per_thread the number of chunks for each thread
+ * @param limits the output array, the chunk c contains the ids in [limits[c],limits[c+1])
+ */
+inline void balanced_chunks(const ivect &cost, int chunks_per_thread, ivect &limits)
+{
+    itype num = cost.size();
+    double total = 0;
+    for(itype i=0; i<num; i++)
+        total += cost[i];
+    double target = total / (get_threads_num()*chunks_per_thread);
+
+    limits.clear();
+    limits.push_back(0);
+    double current = 0;
+    for(itype i=0; i<num; i++)
+    {
+        current += cost[i];
+        if(current >= target && i+1 < num)
+        {
+            limits.push_back(i+1);
+            current = 0;
+        }
+    }
+    limits.push_back(num);
+}
+
+}
+
+#endif // PARALLEL_H
@@ -34,7 +34,7 @@ void Quad_Mesh::loadQuad(Spatial_Mesh &mesh)
     itype num_vert=0;
     for(itype i=0; i<mesh.get_triangles_num(); i++)
     {
-        Triangle &tri = mesh.get_triangle(i);
+        Triangle tri = mesh.get_triangle(i);
 
         //crea vertici
         dvect barycenter = compute_barycenter(i,mesh); //baricentro del tetraedro
@@ -85,7 +85,7 @@ void Quad_Mesh::loadQuad(Spatial_Mesh &mesh)
 
 dvect Quad_Mesh::compute_barycenter(int t, Spatial_Mesh &mesh)
 {
-    Triangle &tri = mesh.get_triangle(t);
+    Triangle tri = mesh.get_triangle(t);
 
     dvect coords = mesh.get_vertex(tri.TV(0)).get_coordinates();
     for(int pos = 1; pos<tri.vertices_num(); pos++)
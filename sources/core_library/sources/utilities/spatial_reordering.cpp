@@ -0,0 +1,113 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "spatial_reordering.h"
+
+#include <algorithm>
+
+#define HILBERT_BITS 16
+#define HILBERT_SIDE (1u << HILBERT_BITS)
+
+uint32_t Spatial_Reordering::hilbert_index(uint32_t x, uint32_t y)
+{
+    uint32_t d = 0;
+    for(uint32_t s = HILBERT_SIDE/2; s > 0; s /= 2)
+    {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant
+        if(ry == 0)
+        {
+            if(rx == 1)
+            {
+                x = HILBERT_SIDE-1 - x;
+                y = HILBERT_SIDE-1 - y;
+            }
+            swap(x,y);
+        }
+    }
+    return d;
+}
+
+void Spatial_Reordering::hilbert_reorder(Spatial_Mesh &mesh, bool keep_original_ids)
+{
+    itype num_v = mesh.get_vertices_num();
+    itype num_t = mesh.get_triangles_num();
+    if(num_v == 0)
+        return;
+
+    // bounding box of the domain
+    coord_type min_x = mesh.get_vertex(0).get_c(0), max_x = min_x;
+    coord_type min_y = mesh.get_vertex(0).get_c(1), max_y = min_y;
+    for(itype v=1; v<num_v; v++)
+    {
+        Vertex &vert = mesh.get_vertex(v);
+        min_x = min(min_x,vert.get_c(0)); max_x = max(max_x,vert.get_c(0));
+        min_y = min(min_y,vert.get_c(1)); max_y = max(max_y,vert.get_c(1));
+    }
+    coord_type scale_x = (max_x > min_x) ? (HILBERT_SIDE-1) / (max_x - min_x) : 0;
+    coord_type scale_y = (max_y > min_y) ? (HILBERT_SIDE-1) / (max_y - min_y) : 0;
+
+    vector<uint64_t> keys(num_v);
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+    {
+        Vertex &vert = mesh.get_vertex(v);
+        uint32_t x = (vert.get_c(0) - min_x) * scale_x;
+        uint32_t y = (vert.get_c(1) - min_y) * scale_y;
+        keys[v] = ((uint64_t)hilbert_index(x,y) << 32) | (uint64_t)v;
+    }
+    ivect v_position;
+    sort_keys(keys,v_position);
+
+    keys.resize(num_t);
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
+    {
+        Triangle tri = mesh.get_triangle(t);
+        coord_type x = 0, y = 0;
+        for(int i=0; i<3; i++)
+        {
+            Vertex &vert = mesh.get_vertex(tri.TV(i));
+            x += vert.get_c(0);
+            y += vert.get_c(1);
+        }
+        uint32_t qx = (x / 3.0 - min_x) * scale_x;
+        uint32_t qy = (y / 3.0 - min_y) * scale_y;
+        keys[t] = ((uint64_t)hilbert_index(qx,qy) << 32) | (uint64_t)t;
+    }
+    ivect t_position;
+    sort_keys(keys,t_position);
+
+    mesh.permute(v_position,t_position,keep_original_ids);
+}
+
+void Spatial_Reordering::sort_keys(vector<uint64_t> &keys, ivect &position)
+{
+    sort(keys.begin(),keys.end());
+    position.assign(keys.size(),-1);
+    #pragma omp parallel for schedule(static)
+    for(itype i=0; i<(itype)keys.size(); i++)
+        position[keys[i] & 0xFFFFFFFFu] = i;
+}
@@ -0,0 +1,70 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPATIAL_REORDERING_H
+#define SPATIAL_REORDERING_H
+
+#include <stdint.h>
+
+#include "ia/mesh.h"
+
+using namespace std;
+///A class that reorders the vertices and the triangles of a mesh following a space-filling curve
+/*!
+ * Vertices (and triangles, using their barycenter) are sorted by the index of their (x,y) position
+ * along the Hilbert curve, so that the elements close in space are also close in memory
+ * and the star walks of the IA access nearby entries.
+ */
+class Spatial_Reordering {
+public:
+    ///A public method that reorders the mesh following the Hilbert curve
+    /*!
+     * NOTA: the procedure must be called before building the IA data structure
+     * \param mesh a Spatial_Mesh& argument, representing the mesh to reorder
+     * \param keep_original_ids a boolean, if true the mesh keeps the input positions of vertices and triangles
+     */
+    static void hilbert_reorder(Spatial_Mesh& mesh, bool keep_original_ids);
+    ///A public method that returns the index along the Hilbert curve of a cell of a 2^16 x 2^16 grid
+    /*!
+     * \param x an unsigned argument, the column of the cell (in [0,2^16))
+     * \param y an unsigned argument, the row of the cell (in [0,2^16))
+     * \return the index of the cell along the curve
+     */
+    static uint32_t hilbert_index(uint32_t x, uint32_t y);
+private:
+    ///A constructor method
+    Spatial_Reordering() {}
+    ///A constructor method
+    Spatial_Reordering(const Spatial_Reordering& ) {}
+    ///A destructor method
+    virtual ~Spatial_Reordering() {}
+
+    ///A private method that computes the new positions of the elements sorting them by their keys
+    /*!
+     * Each key encodes the curve index in the high 32 bits and the element position in the low 32 bits,
+     * thus equal curve indices keep the input order.
+     */
+    static void sort_keys(vector<uint64_t> &keys, ivect &position);
+};
+
+#endif // SPATIAL_REORDERING_H
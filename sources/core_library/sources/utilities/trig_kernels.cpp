@@ -0,0 +1,131 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trig_kernels.h"
+#include "timer.h"
+
+namespace trig_kernels
+{
+
+//fills the block with the triangles in [begin,end)
+static void fill_block(Triangle_Block &b, itype begin, itype end, Spatial_Mesh &mesh)
+{
+    b.num = 0;
+    for(itype t=begin; t<end; t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        b.add(mesh.get_vertex(tr.TV(0)),mesh.get_vertex(tr.TV(1)),mesh.get_vertex(tr.TV(2)));
+    }
+}
+
+//visits all the triangles computing the corners and the normals (with the selected kernels or with the scalar path)
+//and returns the elapsed time of the fastest visit
+static double timed_visit(Spatial_Mesh &mesh, int repetitions, bool scalar, coord_type &checksum)
+{
+    Triangle_Block b;
+    itype num_t = mesh.get_triangles_num();
+    double best = INFINITY;
+    void (* volatile corners_scalar)(Triangle_Block&,int) = triangle_corners_scalar;
+    void (* volatile normal_scalar)(Triangle_Block&,int) = triangle_normal_scalar;
+    for(int r=0; r<repetitions; r++)
+    {
+        Timer time;
+        time.start();
+        checksum = 0;
+        for(itype begin=0; begin<num_t; begin+=TRIG_BLOCK)
+        {
+            itype end = std::min(begin+TRIG_BLOCK,num_t);
+            if(scalar)
+            {
+                // the scalar procedures are called through pointers, as the compiler would vectorize
+                // a loop on the block around the calls of acos and sin (a slower code than the one of the estimators)
+                fill_block(b,begin,end,mesh);
+                for(int i=0; i<b.num; i++)
+                {
+                    corners_scalar(b,i);
+                    normal_scalar(b,i);
+                    checksum += b.angle[0][i] + b.cot[1][i] + b.area[i] + b.ny[i];
+                }
+            }
+            else
+            {
+                fill_block(b,begin,end,mesh);
+                triangle_corners(b);
+                triangle_normals(b);
+                // the checksum keeps the compiler from removing the computation
+                for(int i=0; i<b.num; i++)
+                    checksum += b.angle[0][i] + b.cot[1][i] + b.area[i] + b.ny[i];
+            }
+        }
+        time.stop();
+        best = std::min(best,time.get_elapsed_time());
+    }
+    return best;
+}
+
+void benchmark(Spatial_Mesh &mesh, int repetitions)
+{
+    itype num_t = mesh.get_triangles_num();
+    coord_type checksum_kernels, checksum_scalar;
+    double scalar = timed_visit(mesh,repetitions,true,checksum_scalar);
+    double kernels = timed_visit(mesh,repetitions,false,checksum_kernels);
+    cerr << "[TIME] " << TRIG_KERNELS_ISA << " kernels (width " << TRIG_KERNELS_WIDTH << "): " << kernels << endl;
+    cerr << "[TIME] scalar path: " << scalar << endl;
+    cerr << "[STATS] " << TRIG_KERNELS_ISA << " kernels: " << num_t/kernels << " triangles/sec" << endl;
+    cerr << "[STATS] scalar path: " << num_t/scalar << " triangles/sec" << endl;
+    cerr << "[STATS] speedup: " << scalar/kernels << endl;
+
+    // the maximum differences between the two paths
+    Triangle_Block b, s;
+    coord_type angle = 0, cot = 0, area = 0, normal = 0;
+    for(itype begin=0; begin<num_t; begin+=TRIG_BLOCK)
+    {
+        itype end = std::min(begin+TRIG_BLOCK,num_t);
+        fill_block(b,begin,end,mesh);
+        fill_block(s,begin,end,mesh);
+        triangle_corners(b);
+        triangle_normals(b);
+        for(int i=0; i<s.num; i++)
+        {
+            triangle_corners_scalar(s,i);
+            triangle_normal_scalar(s,i);
+            for(int k=0; k<3; k++)
+            {
+                angle = std::max(angle,fabs(b.angle[k][i]-s.angle[k][i]));
+                if(fabs(s.cos[k][i]) < 0.99 && s.cot[k][i] != 0)
+                    cot = std::max(cot,fabs(b.cot[k][i]-s.cot[k][i])/fabs(s.cot[k][i]));
+            }
+            if(s.area[i] > 0)
+                area = std::max(area,fabs(b.area[i]-s.area[i])/s.area[i]);
+            normal = std::max(normal,std::max(fabs(b.nx[i]-s.nx[i]),std::max(fabs(b.ny[i]-s.ny[i]),fabs(b.nz[i]-s.nz[i]))));
+        }
+    }
+    cerr << "[STATS] max difference of the angles: " << angle << " (absolute)" << endl;
+    cerr << "[STATS] max difference of the cotangents (|cos|<0.99): " << cot << " (relative)" << endl;
+    cerr << "[STATS] max difference of the areas: " << area << " (relative)" << endl;
+    cerr << "[STATS] max difference of the normals: " << normal << " (absolute)" << endl;
+    // printed to keep the visits
+    cerr << "[NOTA] checksums: " << checksum_kernels << " " << checksum_scalar << endl;
+}
+
+}
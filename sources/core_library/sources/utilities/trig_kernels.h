@@ -0,0 +1,431 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIG_KERNELS_H
+#define TRIG_KERNELS_H
+
+#include <math.h>
+#include <type_traits>
+
+#include "basic_wrappers.h"
+#include "ia/vec.h"
+#include "ia/mesh.h"
+
+// the instruction set is selected at compile time (defining TRIG_KERNELS_SCALAR forces the scalar path)
+#if !defined(TRIG_KERNELS_SCALAR) && defined(__AVX512F__)
+#include <immintrin.h>
+#define TRIG_KERNELS_ISA "AVX-512"
+#define TRIG_KERNELS_WIDTH 8
+#elif !defined(TRIG_KERNELS_SCALAR) && defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define TRIG_KERNELS_ISA "AVX2"
+#define TRIG_KERNELS_WIDTH 4
+#elif !defined(TRIG_KERNELS_SCALAR) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TRIG_KERNELS_ISA "NEON"
+#define TRIG_KERNELS_WIDTH 2
+#else
+#define TRIG_KERNELS_ISA "scalar"
+#define TRIG_KERNELS_WIDTH 1
+#endif
+
+///the number of triangles of a Triangle_Block (a multiple of all the pack widths)
+#define TRIG_BLOCK 64
+
+/**
+ * @brief A set of kernels computing the angle-based quantities (cosinus, angles, cotangents, areas and normals)
+ * of blocks of triangles, using the SIMD instructions available at compile time (AVX-512, AVX2 or NEON).
+ *
+ * The scalar path calls acos and computes the cotangents as cos/sin(acos(cos)), thus it gives the same values
+ * of the procedures of Geometry_Curvature and Geometry_Slope.
+ * The SIMD path computes acos with a polynomial and the cotangents as cos/sqrt((1-cos)(1+cos)).
+ * Accuracy bound of the SIMD path versus the scalar path:
+ *  - acos: absolute error at most 1 ulp of the result (4.5e-16), on all the doubles in [-1,1] with a step of 1e-7;
+ *  - cotangents: the SIMD formula has a relative error below 2.5e-16, while the scalar one loses accuracy
+ *    as |cos| grows (1.6e-15 for |cos| < 0.99, 1.5e-12 for |cos| < 1-1e-8): the two differ by these amounts.
+ *    At a flat angle (cos = -1) the scalar cotangent is finite (sin(acos(-1)) is not zero), while the SIMD one is infinite:
+ *    the estimators skip the cotangents of flat angles;
+ *  - lengths, cosinus, areas and normals use the same formulas in the same order, without FMA instructions
+ *    (see dot3, and the build disables the FMA contraction of the scalar path): they are the same on the two paths.
+ * Measured with the trigbench operation on terrains from 80K to 1M triangles: angles differ by at most 4.5e-16
+ * (absolute), cotangents by 1.5e-15 (relative, |cos| < 0.99), areas and normals are identical.
+ * On a terrain with 1M triangles the Concentrated curvatures differ by at most 3e-15 (absolute, the values close to zero
+ * have a larger relative difference), the Mean curvatures with --scatter by 1.1e-12 (relative).
+ */
+namespace trig_kernels
+{
+
+/**
+ * @brief The coordinates of a block of triangles (in a structure-of-arrays layout) and the quantities computed by the kernels
+ */
+struct Triangle_Block
+{
+    ///the number of triangles in the block
+    int num;
+    ///the coordinates of the three vertices of each triangle
+    coord_type x[3][TRIG_BLOCK], y[3][TRIG_BLOCK], z[3][TRIG_BLOCK];
+    ///for each corner i (by triangle_corners): the length of the opposite edge (from the vertex i+1 to the vertex i+2),
+    ///the cosinus (in [-1,1]), the angle and the cotangent
+    coord_type len[3][TRIG_BLOCK], cos[3][TRIG_BLOCK], angle[3][TRIG_BLOCK], cot[3][TRIG_BLOCK];
+    ///the area of each triangle (by triangle_corners, as Geometry_Curvature::triangle_area)
+    coord_type area[TRIG_BLOCK];
+    ///the unit normal of each triangle (by triangle_normals, as Geometry_Curvature::triangle_normal)
+    coord_type nx[TRIG_BLOCK], ny[TRIG_BLOCK], nz[TRIG_BLOCK];
+
+    Triangle_Block() { num = 0; }
+    ///A public method that appends a triangle to the block
+    inline void add(const Vertex &p0, const Vertex &p1, const Vertex &p2)
+    {
+        const Vertex *p[3] = { &p0, &p1, &p2 };
+        for(int k=0; k<3; k++)
+        {
+            x[k][num] = p[k]->get_c(0);
+            y[k][num] = p[k]->get_c(1);
+            z[k][num] = p[k]->get_c(2);
+        }
+        num++;
+    }
+    ///A public method that replicates the last triangle up to a multiple of the pack width
+    inline void pad()
+    {
+        for(int i=num; i%TRIG_KERNELS_WIDTH != 0; i++)
+        {
+            for(int k=0; k<3; k++)
+            {
+                x[k][i] = x[k][num-1];
+                y[k][i] = y[k][num-1];
+                z[k][i] = z[k][num-1];
+            }
+        }
+    }
+    inline Vec3 get_vertex(int k, int i) const { return Vec3(x[k][i],y[k][i],z[k][i]); }
+};
+
+/**
+ * @brief A procedure that computes the quantities of the corners of the i-th triangle of the block, with the scalar path
+ */
+inline void triangle_corners_scalar(Triangle_Block &b, int i)
+{
+    Vec3 p[3] = { b.get_vertex(0,i), b.get_vertex(1,i), b.get_vertex(2,i) };
+
+    // e[k] is the edge opposite to the corner k, from p[k+1] to p[k+2]
+    Vec3 e[3];
+    for(int k=0; k<3; k++)
+    {
+        e[k] = p[(k+2)%3] - p[(k+1)%3];
+        b.len[k][i] = e[k].norm();
+    }
+
+    // the edges leaving corner k are -e[k+2] and e[k+1]
+    coord_type cos0 = 0;
+    for(int k=0; k<3; k++)
+    {
+        coord_type c = (-e[(k+2)%3]).dot(e[(k+1)%3])/(b.len[(k+2)%3][i]*b.len[(k+1)%3][i]);
+        if(k == 0)
+            cos0 = c;
+        if (c>1.0) c = 1.0;
+        if (c<-1.0) c = -1.0;
+        b.cos[k][i] = c;
+        b.angle[k][i] = ::acos(c);
+        b.cot[k][i] = c / sin(::acos(c));
+    }
+
+    coord_type senalpha = sqrt(1-(cos0*cos0));
+    if(std::isnan(senalpha)) senalpha=0.0001;
+    b.area[i] = (b.len[2][i]*b.len[1][i]*senalpha)/2;
+}
+
+/**
+ * @brief A procedure that computes the unit normal of the i-th triangle of the block, with the scalar path
+ */
+inline void triangle_normal_scalar(Triangle_Block &b, int i)
+{
+    Vec3 p0 = b.get_vertex(0,i);
+    Vec3 n = (p0 - b.get_vertex(1,i)).cross(p0 - b.get_vertex(2,i));
+    n = n / n.norm();
+    b.nx[i] = n.x;
+    b.ny[i] = n.y;
+    b.nz[i] = n.z;
+}
+
+#if TRIG_KERNELS_WIDTH > 1
+
+static_assert(std::is_same<coord_type,double>::value, "the SIMD kernels require double coordinates");
+
+///the wrappers of the SIMD instructions
+namespace isa
+{
+#if TRIG_KERNELS_WIDTH == 8
+typedef __m512d pack;
+typedef __mmask8 mask;
+inline pack load(const coord_type *p) { return _mm512_loadu_pd(p); }
+inline void store(coord_type *p, pack a) { _mm512_storeu_pd(p,a); }
+inline pack set(coord_type c) { return _mm512_set1_pd(c); }
+inline pack add(pack a, pack b) { return _mm512_add_pd(a,b); }
+inline pack sub(pack a, pack b) { return _mm512_sub_pd(a,b); }
+inline pack mul(pack a, pack b) { return _mm512_mul_pd(a,b); }
+inline pack div(pack a, pack b) { return _mm512_div_pd(a,b); }
+inline pack fma(pack a, pack b, pack c) { return _mm512_fmadd_pd(a,b,c); }
+inline pack sqrt(pack a) { return _mm512_sqrt_pd(a); }
+inline pack abs(pack a) { return _mm512_abs_pd(a); }
+inline pack min(pack a, pack b) { return _mm512_min_pd(a,b); }
+inline pack max(pack a, pack b) { return _mm512_max_pd(a,b); }
+inline mask less(pack a, pack b) { return _mm512_cmp_pd_mask(a,b,_CMP_LT_OQ); }
+inline mask is_nan(pack a) { return _mm512_cmp_pd_mask(a,a,_CMP_UNORD_Q); }
+///returns a where m is set, b otherwise
+inline pack select(mask m, pack a, pack b) { return _mm512_mask_blend_pd(m,b,a); }
+#elif TRIG_KERNELS_WIDTH == 4
+typedef __m256d pack;
+typedef __m256d mask;
+inline pack load(const coord_type *p) { return _mm256_loadu_pd(p); }
+inline void store(coord_type *p, pack a) { _mm256_storeu_pd(p,a); }
+inline pack set(coord_type c) { return _mm256_set1_pd(c); }
+inline pack add(pack a, pack b) { return _mm256_add_pd(a,b); }
+inline pack sub(pack a, pack b) { return _mm256_sub_pd(a,b); }
+inline pack mul(pack a, pack b) { return _mm256_mul_pd(a,b); }
+inline pack div(pack a, pack b) { return _mm256_div_pd(a,b); }
+inline pack fma(pack a, pack b, pack c) { return _mm256_fmadd_pd(a,b,c); }
+inline pack sqrt(pack a) { return _mm256_sqrt_pd(a); }
+inline pack abs(pack a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0),a); }
+inline pack min(pack a, pack b) { return _mm256_min_pd(a,b); }
+inline pack max(pack a, pack b) { return _mm256_max_pd(a,b); }
+inline mask less(pack a, pack b) { return _mm256_cmp_pd(a,b,_CMP_LT_OQ); }
+inline mask is_nan(pack a) { return _mm256_cmp_pd(a,a,_CMP_UNORD_Q); }
+///returns a where m is set, b otherwise
+inline pack select(mask m, pack a, pack b) { return _mm256_blendv_pd(b,a,m); }
+#else
+typedef float64x2_t pack;
+typedef uint64x2_t mask;
+inline pack load(const coord_type *p) { return vld1q_f64(p); }
+inline void store(coord_type *p, pack a) { vst1q_f64(p,a); }
+inline pack set(coord_type c) { return vdupq_n_f64(c); }
+inline pack add(pack a, pack b) { return vaddq_f64(a,b); }
+inline pack sub(pack a, pack b) { return vsubq_f64(a,b); }
+inline pack mul(pack a, pack b) { return vmulq_f64(a,b); }
+inline pack div(pack a, pack b) { return vdivq_f64(a,b); }
+inline pack fma(pack a, pack b, pack c) { return vfmaq_f64(c,a,b); }
+inline pack sqrt(pack a) { return vsqrtq_f64(a); }
+inline pack abs(pack a) { return vabsq_f64(a); }
+inline pack min(pack a, pack b) { return vminq_f64(a,b); }
+inline pack max(pack a, pack b) { return vmaxq_f64(a,b); }
+inline mask less(pack a, pack b) { return vcltq_f64(a,b); }
+inline mask is_nan(pack a) { return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(a,a)))); }
+///returns a where m is set, b otherwise
+inline pack select(mask m, pack a, pack b) { return vbslq_f64(m,a,b); }
+#endif
+}
+
+/**
+ * @brief A procedure that computes acos on a pack of values in [-1,1]
+ *
+ * asin(s) = s + s*z*P(z), with z = s*s and s in [0,0.5], where P is the degree 12 interpolant of (asin(s)-s)/(s*z)
+ * in the Chebyshev nodes of [0,0.25] (error below 3e-18); for |x| > 0.5, acos(|x|) = 2*asin(sqrt((1-|x|)/2)).
+ */
+inline isa::pack acos(isa::pack x)
+{
+    using namespace isa;
+    static const coord_type P[13] = {
+        0.16666666666666669, 0.07499999999998433, 0.04464285714635543, 0.030381944138531247,
+        0.02237217294214989, 0.017352392720869973, 0.013971212973552933, 0.011479177415184906,
+        0.01032281435018578, 0.005457506718640358, 0.01740087944269402, -0.014851887071247204,
+        0.028757851367421566 };
+    // pi/2 split in two doubles
+    const pack pio2_hi = set(1.57079632679489655800e+00), pio2_lo = set(6.12323399573676603587e-17);
+
+    pack a = abs(x);
+    mask big = less(set(0.5),a);
+    mask negative = less(x,set(0.0));
+    pack z_big = mul(sub(set(1.0),a),set(0.5));
+    pack z = select(big,z_big,mul(a,a));
+    pack s = select(big,sqrt(z_big),a);
+
+    pack p = set(P[12]);
+    for(int i=11; i>=0; i--)
+        p = fma(p,z,set(P[i]));
+    pack r = fma(mul(s,z),p,s); // asin(s)
+
+    // |x| <= 0.5: acos(x) = pi/2 -+ asin(|x|)
+    pack small_pos = sub(pio2_hi,sub(r,pio2_lo));
+    pack small_neg = add(pio2_hi,add(r,pio2_lo));
+    // |x| > 0.5: acos(x) = 2*asin(s) or pi - 2*asin(s)
+    pack big_pos = add(r,r);
+    pack big_neg = add(small_pos,small_pos);
+    return select(big,select(negative,big_neg,big_pos),select(negative,small_neg,small_pos));
+}
+
+/**
+ * @brief A procedure that computes the dot products of two packs of vectors, in the order of Vec3::dot and without
+ * FMA instructions (thus the lengths and the cosinus are the same of the scalar path)
+ */
+inline isa::pack dot3(isa::pack ax, isa::pack ay, isa::pack az, isa::pack bx, isa::pack by, isa::pack bz)
+{
+    using namespace isa;
+    return add(add(mul(ax,bx),mul(ay,by)),mul(az,bz));
+}
+
+/**
+ * @brief A procedure that computes the cotangents of a pack of angles given their cosinus (in [-1,1])
+ */
+inline isa::pack cotangent(isa::pack c)
+{
+    using namespace isa;
+    pack one = set(1.0);
+    return div(c,sqrt(mul(sub(one,c),add(one,c))));
+}
+
+/**
+ * @brief A procedure that computes the quantities of the corners of the triangles in [i,i+TRIG_KERNELS_WIDTH) of the block
+ */
+inline void triangle_corners_pack(Triangle_Block &b, int i)
+{
+    using namespace isa;
+    pack x[3], y[3], z[3];
+    for(int k=0; k<3; k++)
+    {
+        x[k] = load(&b.x[k][i]);
+        y[k] = load(&b.y[k][i]);
+        z[k] = load(&b.z[k][i]);
+    }
+
+    pack ex[3], ey[3], ez[3], len[3];
+    for(int k=0; k<3; k++)
+    {
+        ex[k] = sub(x[(k+2)%3],x[(k+1)%3]);
+        ey[k] = sub(y[(k+2)%3],y[(k+1)%3]);
+        ez[k] = sub(z[(k+2)%3],z[(k+1)%3]);
+        len[k] = sqrt(dot3(ex[k],ey[k],ez[k],ex[k],ey[k],ez[k]));
+        store(&b.len[k][i],len[k]);
+    }
+
+    pack cos0 = set(0.0);
+    for(int k=0; k<3; k++)
+    {
+        int in = (k+2)%3, out = (k+1)%3;
+        pack dot = dot3(ex[in],ey[in],ez[in],ex[out],ey[out],ez[out]);
+        pack c = div(sub(set(0.0),dot),mul(len[in],len[out]));
+        if(k == 0)
+            cos0 = c;
+        c = min(max(c,set(-1.0)),set(1.0));
+        store(&b.cos[k][i],c);
+        store(&b.angle[k][i],acos(c));
+        store(&b.cot[k][i],cotangent(c));
+    }
+
+    pack sen = sqrt(sub(set(1.0),mul(cos0,cos0)));
+    sen = select(is_nan(sen),set(0.0001),sen);
+    store(&b.area[i],mul(mul(mul(len[2],len[1]),sen),set(0.5)));
+}
+
+/**
+ * @brief A procedure that computes the unit normals of the triangles in [i,i+TRIG_KERNELS_WIDTH) of the block
+ */
+inline void triangle_normal_pack(Triangle_Block &b, int i)
+{
+    using namespace isa;
+    pack x0 = load(&b.x[0][i]), y0 = load(&b.y[0][i]), z0 = load(&b.z[0][i]);
+    pack ax = sub(x0,load(&b.x[1][i])), ay = sub(y0,load(&b.y[1][i])), az = sub(z0,load(&b.z[1][i]));
+    pack bx = sub(x0,load(&b.x[2][i])), by = sub(y0,load(&b.y[2][i])), bz = sub(z0,load(&b.z[2][i]));
+
+    pack nx = sub(mul(ay,bz),mul(az,by));
+    pack ny = sub(mul(az,bx),mul(ax,bz));
+    pack nz = sub(mul(ax,by),mul(ay,bx));
+    pack norm = sqrt(dot3(nx,ny,nz,nx,ny,nz));
+    store(&b.nx[i],div(nx,norm));
+    store(&b.ny[i],div(ny,norm));
+    store(&b.nz[i],div(nz,norm));
+}
+
+#endif
+
+/**
+ * @brief A procedure that computes, for each triangle of the block, the lengths, cosinus, angles and cotangents of its corners and its area
+ */
+inline void triangle_corners(Triangle_Block &b)
+{
+#if TRIG_KERNELS_WIDTH > 1
+    b.pad();
+    for(int i=0; i<b.num; i+=TRIG_KERNELS_WIDTH)
+        triangle_corners_pack(b,i);
+#else
+    for(int i=0; i<b.num; i++)
+        triangle_corners_scalar(b,i);
+#endif
+}
+
+/**
+ * @brief A procedure that computes the unit normal of each triangle of the block
+ */
+inline void triangle_normals(Triangle_Block &b)
+{
+#if TRIG_KERNELS_WIDTH > 1
+    b.pad();
+    for(int i=0; i<b.num; i+=TRIG_KERNELS_WIDTH)
+        triangle_normal_pack(b,i);
+#else
+    for(int i=0; i<b.num; i++)
+        triangle_normal_scalar(b,i);
+#endif
+}
+
+/**
+ * @brief A procedure that computes acos of num values in [-1,1]
+ *
+ * @param c the input values
+ * @param angle the output array (it can coincide with c)
+ * @param num the number of values
+ */
+inline void acos(const coord_type *c, coord_type *angle, itype num)
+{
+#if TRIG_KERNELS_WIDTH > 1
+    itype i = 0;
+    for(; i+TRIG_KERNELS_WIDTH<=num; i+=TRIG_KERNELS_WIDTH)
+        isa::store(&angle[i],acos(isa::load(&c[i])));
+    if(i < num)
+    {
+        // the last values are computed on a padded pack, thus a value does not depend on its position
+        coord_type tail[TRIG_KERNELS_WIDTH];
+        for(int j=0; j<TRIG_KERNELS_WIDTH; j++)
+            tail[j] = c[(i+j < num) ? i+j : num-1];
+        isa::store(tail,acos(isa::load(tail)));
+        for(int j=0; i+j<num; j++)
+            angle[i+j] = tail[j];
+    }
+#else
+    for(itype i=0; i<num; i++)
+        angle[i] = ::acos(c[i]);
+#endif
+}
+
+/**
+ * @brief A procedure that measures the throughput (triangles per second, on a single thread) of the kernels
+ * of the instruction set selected at compile time and of the scalar path on the triangles of a mesh,
+ * and the maximum differences between the two paths
+ *
+ * @param mesh the triangle mesh
+ * @param repetitions the number of visits of the triangles (the fastest one is reported)
+ */
+void benchmark(Spatial_Mesh &mesh, int repetitions);
+
+}
+
+#endif // TRIG_KERNELS_H
@@ -24,13 +24,21 @@
 
 #include "abstract_curvature.h"
 
-//compute for all vertices
-void AbstractCurvature::compute_values(Spatial_Mesh &mesh)
+void AbstractCurvature::balanced_chunks(Spatial_Mesh &mesh, ivect &limits)
 {
-    for(itype i=0; i<mesh.get_vertices_num(); i++)
+    // the cost of a vertex is estimated by the number of its incident triangles
+    ivect cost(mesh.get_vertices_num(),1);
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<mesh.get_triangles_num(); t++)
     {
-        curvature[i]=compute(i,mesh); //mean angle deficit
+        Triangle tr = mesh.get_triangle(t);
+        for(int i=0; i<tr.vertices_num(); i++)
+        {
+            #pragma omp atomic
+            cost[tr.TV(i)]++;
+        }
     }
+    parallel::balanced_chunks(cost,16,limits);
 }
 
 void AbstractCurvature::print_curvature_stats(Spatial_Mesh &mesh)
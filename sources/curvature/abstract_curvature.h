@@ -28,15 +28,28 @@
 #include "ia/mesh.h"
 #include "ia/vertex.h"
 #include "ia/triangle.h"
+#include "plane_sweep.h"
+#include "utilities/parallel.h"
 
+///reusable buffers of a thread computing the curvature values
+struct Curvature_Buffers
+{
+    ivect vt, vv;
+    dvect values;
+    Plane_Sweep sweep;
+};
+
+//the runtime interface of the curvature estimators (e.g., for selecting them from the command line)
 class AbstractCurvature
 {
 public:
-    //compute for all vertices
-    void compute_values(Spatial_Mesh &mesh);
+    virtual ~AbstractCurvature() {}
+    //compute for all vertices (in parallel, each thread on contiguous chunks of vertices with a similar number of incident triangles)
+    virtual void compute_values(Spatial_Mesh &mesh)=0;
     ///
     inline coord_type get_curvature(itype pos) { return curvature[pos]; }
     inline void set_curvature(int pos, coord_type curv) { this->curvature[pos] = curv; }
+    inline const dvect& get_curvatures() { return curvature; }
 
     void print_curvature_stats(Spatial_Mesh &mesh);
 
@@ -52,8 +65,44 @@ protected:
         curvature.assign(mesh.get_vertices_num(),0);
     }
 
-    virtual coord_type compute(itype v, Spatial_Mesh &mesh)=0;
+    //splits the vertices in chunks with a similar number of incident triangles
+    static void balanced_chunks(Spatial_Mesh &mesh, ivect &limits);
+};
+
+//the estimators derive from Curvature_Estimator<Estimator> and define (accessible to this class):
+// - coord_type compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers), the estimation of the curvature at vertex v,
+//   using the buffers of the calling thread
+// - void prepare_values(Spatial_Mesh &mesh) (optional), called before computing the values in parallel
+//   (e.g., for getting the shared fields of the mesh)
+//the loop on the vertices calls compute statically: the estimator source file instantiates Curvature_Estimator<Estimator>
+//after defining compute, which is thus inlined in the loop (the header declares the instantiation as extern)
+template<class Estimator> class Curvature_Estimator : public AbstractCurvature
+{
+public:
+    void compute_values(Spatial_Mesh &mesh);
 
+protected:
+    Curvature_Estimator(Spatial_Mesh &mesh, bool div_area=false) : AbstractCurvature(mesh,div_area) {}
+    void prepare_values(Spatial_Mesh &) {}
 };
 
+template<class Estimator> void Curvature_Estimator<Estimator>::compute_values(Spatial_Mesh &mesh)
+{
+    Estimator &estimator = static_cast<Estimator&>(*this);
+    estimator.prepare_values(mesh);
+
+    ivect limits;
+    balanced_chunks(mesh,limits);
+
+    // each value depends only on its vertex, thus the result does not depend on the schedule
+    vector<Curvature_Buffers> buffers(parallel::get_threads_num());
+    #pragma omp parallel for schedule(dynamic,1)
+    for(itype c=0; c<(itype)limits.size()-1; c++)
+    {
+        Curvature_Buffers &b = buffers[parallel::get_thread_id()];
+        for(itype v=limits[c]; v<limits[c+1]; v++)
+            curvature[v]=estimator.compute(v,mesh,b);
+    }
+}
+
 #endif // ABSTRACT_CURVATURE_H
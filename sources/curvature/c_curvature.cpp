@@ -25,10 +25,11 @@
 #include <cstdio>
 
 #include "c_curvature.h"
+#include "utilities/parallel.h"
 
 //compute curvature of polyline segment p1 v2 p3 and set its sign 
 //according to the direction of surface normal v2norm at vertex v2
-coord_type C_Curvature::wedge_curvature(Vertex &p1, Vertex &v2, Vertex &p3, Vertex &v2norm)
+coord_type C_Curvature::wedge_curvature(const Vec3 &p1, const Vec3 &v2, const Vec3 &p3, const Vec3 &v2norm)
 {
     coord_type cosinus, curva;
 
@@ -39,7 +40,7 @@ coord_type C_Curvature::wedge_curvature(Vertex &p1, Vertex &v2, Vertex &p3, Vert
     if (curva==0.0)
         return curva;
 
-    Vertex v2_plus_norm = v2 + v2norm;
+    Vec3 v2_plus_norm = v2 + v2norm;
     coord_type cos2, cos3, ang1, ang2, ang3;
 
     if (cosinus<=-1.0)
@@ -72,65 +73,56 @@ coord_type C_Curvature::wedge_curvature(Vertex &p1, Vertex &v2, Vertex &p3, Vert
 //Given vertex v, its normal vnorm, and a point w, compute the curvature
 //in v of the line obtained by intersecting the surface with the plane
 //through v, vnorm, and w.
-coord_type C_Curvature::compute_curve_and_curvature(itype v_id, Vertex &v, ivect &vt, Vertex &vnorm, Vertex &w, Spatial_Mesh &mesh)
+coord_type C_Curvature::compute_curve_and_curvature(itype v_id, const Vec3 &v, ivect &vt, const Vec3 &vnorm, const Vec3 &w, Spatial_Mesh &mesh,
+                                                    Plane_Sweep *sweep, itype i)
 {
-//    cout<<"compute_curve_and_curvature"<<endl;
-    dvect abc= { 0, 0, 0 };// coefficients of plane through v,w and parallel to normal
-
-    Vertex sub = v - w;
-    abc[0] =  +vnorm.get_c(2)*(sub.get_c(1)) -vnorm.get_c(1)*(sub.get_c(2));
-    abc[1] =  -vnorm.get_c(2)*(sub.get_c(0)) +vnorm.get_c(0)*(sub.get_c(2));
-    abc[2] =  -vnorm.get_c(0)*(sub.get_c(1)) +vnorm.get_c(1)*(sub.get_c(0));
+    // coefficients of plane through v,w and parallel to normal
+    Vec3 abc = (v - w).cross(vnorm);
     // il piano ha equazione:
     // a(x-vx)+b(y-vy)+c(z-vz)=0 dove v=(vx,vy,vz)
 
-    Vertex w1 = Geometry_Curvature::find_plane_intersection(v_id, v, vt, vnorm, w, abc, mesh);
+    Vec3 w1;
+    if(sweep == NULL || !sweep->find_plane_intersection(i, w, abc, w1))
+        w1 = Geometry_Curvature::find_plane_intersection(v_id, v, vt, vnorm, w, abc, mesh);
 
     //take curvature of wedge w v w1
     return wedge_curvature(w,v,w1, vnorm);
 }
 
 //function for computing mean and gaussian Ccurvature
-coord_type C_Curvature::compute(itype v, Spatial_Mesh &mesh)
+inline coord_type C_Curvature::compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers)
 {
-    Vertex &vert = mesh.get_vertex(v);
+    ivect &vt = buffers.vt;
+    ivect &vv = buffers.vv;
+    Vec3 vert = mesh.get_vertex(v);
 
-    itype v1,v2;
-    Vertex vnorm(vert.get_dimension()), tnorm(vert.get_dimension());
-    coord_type totang;
-    coord_type cc;
     bool is_border = false; //forse non serve
-    coord_type l;
-    coord_type cc_sum = 0.0; // really used only if (take_mean_of_all)
 
-    ivect vt = mesh.VT(v,is_border);
-    ivect vv = mesh.VV(v);
+    mesh.VT(v,vt,is_border);
+    mesh.VV(v,vv);
 
     if (vt.size()==1) return 0.0; //one incident, we say that v is flat vertex
 
-    //compute total angle at v and vertex normal as a weighted
-    //sum of triangle normals, the weight of each triangle is
-    //its angle in v.
-    totang = 0.0;
+    //the vertex normal is the sum of the triangle normals weighted
+    //by their angle in v (see Normal_Field)
+    Vec3 vnorm = normals->get_vertex_normal(v);
 
-    for(auto t : vt)
-    {
-        coord_type ang;
-        Triangle &tr = mesh.get_triangle(t);
-        int v_pos = tr.vertex_index(v);
-        v1 = tr.TV((v_pos+1)%3);
-        v2 = tr.TV((v_pos+2)%3);
-        ang = acos(Geometry_Curvature::cos_angle(mesh.get_vertex(v1),vert,mesh.get_vertex(v2)));
-        totang += ang;
-        Geometry_Curvature::triangle_normal(tr,tnorm,mesh);
-        vnorm += tnorm * ang;
-    }
-    vnorm /= (vt.size()*totang);
-    l = vnorm.norm();
-    vnorm /= l;
+    coord_type max_cur, min_cur, cc_sum;
+    compute_curves(v,vert,vt,&vv[0],vv.size(),is_border,vnorm,mesh,buffers.sweep,min_cur,max_cur,cc_sum);
 
-    coord_type max_cur=-INFINITY;
-    coord_type min_cur=INFINITY;
+    return curves_curvature(min_cur,max_cur,cc_sum,vv.size());
+}
+
+//the curves around v: their minimum and maximum curvature, and the sum of the curvatures
+void C_Curvature::compute_curves(itype v, const Vec3 &vert, ivect &vt, const itype *vv, itype vv_num, bool is_border, const Vec3 &vnorm,
+                                 Spatial_Mesh &mesh, Plane_Sweep &sweep, coord_type &min_cur, coord_type &max_cur, coord_type &cc_sum)
+{
+    // on the larger stars, a sweep finds the intersections of all the planes in a time linear in the number of triangles
+    Plane_Sweep *swept = (plane_sweep && sweep.prepare(v,vert,vt,vv,vv_num,is_border,vnorm,mesh)) ? &sweep : NULL;
+
+    max_cur=-INFINITY;
+    min_cur=INFINITY;
+    cc_sum = 0.0;
 
     //outer loop on neighbor vertices w represented by incident triangles
     //(consider w = the first vertex following v in each triangle),
@@ -138,9 +130,9 @@ coord_type C_Curvature::compute(itype v, Spatial_Mesh &mesh)
     // to v intersects the plane through v and w and parallel to the surface
     // normal in v; compute the plane-edge intersection poits w1;
     //and compute curvature of curve w v w1, store min and max
-    for(auto vid : vv)
+    for(itype i=0; i<vv_num; i++)
     {
-        cc = compute_curve_and_curvature(v,vert,vt,vnorm,mesh.get_vertex(vid),mesh);
+        coord_type cc = compute_curve_and_curvature(v,vert,vt,vnorm,mesh.get_vertex(vv[i]),mesh,swept,i);
 
         if (cc<min_cur)
             min_cur = cc;
@@ -148,12 +140,21 @@ coord_type C_Curvature::compute(itype v, Spatial_Mesh &mesh)
             max_cur = cc;
         cc_sum += cc; // really used only if (take_mean_of_all)
     }
+}
+
+void C_Curvature::prepare_values(Spatial_Mesh &mesh)
+{
+    normals = &mesh.get_normal_field();
+}
 
+//combine the curvatures of the curves around a vertex, depending on the type
+coord_type C_Curvature::curves_curvature(coord_type min_cur, coord_type max_cur, coord_type cc_sum, itype num)
+{
     //mean Ccurvature
     if (type==MEAN_CCURVATURE)
     {
         if (take_mean_of_all)
-            return (cc_sum/vv.size());
+            return (cc_sum/num);
         else
             return ((min_cur+max_cur)/2.0);
     }
@@ -164,12 +165,43 @@ coord_type C_Curvature::compute(itype v, Spatial_Mesh &mesh)
     return 0.0;
 }
 
+void C_Curvature::compute_values_from_stars(Curvature_Stars &stars, Spatial_Mesh &mesh, C_Curvature &gauss, C_Curvature &mean)
+{
+    ivect &limits = stars.get_chunks();
+    vector<Curvature_Buffers> buffers(parallel::get_threads_num());
+    #pragma omp parallel for schedule(dynamic,1)
+    for(itype c=0; c<(itype)limits.size()-1; c++)
+    {
+        ivect &vt = buffers[parallel::get_thread_id()].vt;
+        for(itype v=limits[c]; v<limits[c+1]; v++)
+        {
+            if (stars.get_VT_num(v)==1) //one incident, we say that v is flat vertex
+            {
+                gauss.curvature[v] = mean.curvature[v] = 0.0;
+                continue;
+            }
+
+            Vec3 vert = mesh.get_vertex(v);
+            vt.assign(stars.get_VT(v),stars.get_VT(v)+stars.get_VT_num(v));
+
+            // the curves around v are the same for both the types
+            coord_type max_cur, min_cur, cc_sum;
+            gauss.compute_curves(v,vert,vt,stars.get_VV(v),stars.get_VV_num(v),stars.is_border(v),stars.get_normal(v),mesh,
+                                 buffers[parallel::get_thread_id()].sweep,min_cur,max_cur,cc_sum);
+            gauss.curvature[v] = gauss.curves_curvature(min_cur,max_cur,cc_sum,stars.get_VV_num(v));
+            mean.curvature[v] = mean.curves_curvature(min_cur,max_cur,cc_sum,stars.get_VV_num(v));
+        }
+    }
+}
+
 //constructor: read mesh and compute curvature for each vertex
 C_Curvature :: C_Curvature(CCurvatureType tp, /*, coord_type as*/ Spatial_Mesh &mesh, bool mn)
-    : AbstractCurvature(mesh)
+    : Curvature_Estimator(mesh)
 {    
     type = tp;
     take_mean_of_all = mn;
+    normals = NULL;
+    plane_sweep = true;
     if (type==MEAN_CCURVATURE)
     {
         printf("Mean Ccurvature with mean as ");
@@ -182,3 +214,5 @@ C_Curvature :: C_Curvature(CCurvatureType tp, /*, coord_type as*/ Spatial_Mesh &
     }
     else printf("Error: type of Ccurvature is not valid\n");
 }
+
+template class Curvature_Estimator<C_Curvature>;
@@ -28,32 +28,54 @@
 
 #include "abstract_curvature.h"
 #include "geometry_curvature.h"
+#include "curvature_stars.h"
 
 enum CCurvatureType {GAUSS_CCURVATURE = 0, MEAN_CCURVATURE = 1};
 
-class C_Curvature : public AbstractCurvature
+class C_Curvature : public Curvature_Estimator<C_Curvature>
 {
+    friend class Curvature_Estimator<C_Curvature>;
+
 protected:
     //type of Ccurvature: MEAN_CCURVATURE or GAUSS_CCURVATURE
     CCurvatureType type;
     //in case of mean Ccurvature, if 1 compute mean as sum of all values
     //divided by number of values, instead of min+max divided by two
     bool take_mean_of_all;
+    //if 1 the intersections of the planes with the stars of (at least SWEEP_MIN_DEGREE) triangles are found by a sweep
+    bool plane_sweep;
+    //the normals of the mesh (got before computing the values)
+    Normal_Field *normals;
+    //gets the normals of the mesh
+    void prepare_values(Spatial_Mesh &mesh);
     //curvature estimation function: depending on type
-    coord_type compute(itype v, Spatial_Mesh &mesh);
+    coord_type compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers);
     //compute curvature of polyline segment p1 v2 p3
     //and set its sign according to the direction of
     //surface normal v2norm at vertex v2
-    coord_type wedge_curvature(Vertex &p1, Vertex &v2, Vertex &p3, Vertex &v2norm);
+    coord_type wedge_curvature(const Vec3 &p1, const Vec3 &v2, const Vec3 &p3, const Vec3 &v2norm);
     //Given vertex v, its normal vnorm, and a point w, compute the curvature
     //in v of the line obtained by intersecting the surface with the plane
-    //through v, vnorm, and w.
-    coord_type compute_curve_and_curvature(itype v_id, Vertex &v, ivect &vt, Vertex &vnorm, Vertex &w, Spatial_Mesh &mesh);
+    //through v, vnorm, and w (the i-th vertex of VV, for the sweep of the star if not NULL).
+    coord_type compute_curve_and_curvature(itype v_id, const Vec3 &v, ivect &vt, const Vec3 &vnorm, const Vec3 &w, Spatial_Mesh &mesh,
+                                           Plane_Sweep *sweep=NULL, itype i=0);
+    //the curves around v: their minimum and maximum curvature, and the sum of the curvatures
+    void compute_curves(itype v, const Vec3 &vert, ivect &vt, const itype *vv, itype vv_num, bool is_border, const Vec3 &vnorm,
+                        Spatial_Mesh &mesh, Plane_Sweep &sweep, coord_type &min_cur, coord_type &max_cur, coord_type &cc_sum);
+    //combine the curvatures of the num curves around a vertex (their minimum, maximum and sum), depending on the type
+    coord_type curves_curvature(coord_type min_cur, coord_type max_cur, coord_type cc_sum, itype num);
 
 public:
     //constructor given the type (see above for values), the flag whether
     //we compute mean by summing all values
     C_Curvature(CCurvatureType tp, Spatial_Mesh &mesh, bool mn=false);
+    //enables (default) or disables the sweep of the stars
+    inline void set_plane_sweep(bool s) { plane_sweep = s; }
+    //compute both the Gaussian and the Mean Ccurvature for all vertices, from the normals and the stars
+    //collected by a visit shared with other estimators (the curves around each vertex are computed once)
+    static void compute_values_from_stars(Curvature_Stars &stars, Spatial_Mesh &mesh, C_Curvature &gauss, C_Curvature &mean);
 };
 
+extern template class Curvature_Estimator<C_Curvature>;
+
 #endif //C_CURVATURE_H
@@ -24,29 +24,35 @@
 
 #include "concentrated_curvature.h"
 #include "geometry_curvature.h"
+#include "utilities/trig_kernels.h"
 
 //function for computing mean angle deficit curvature at vertex v
-coord_type ConcentratedCurvature::compute(itype v, Spatial_Mesh &mesh)
+inline coord_type ConcentratedCurvature::compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers)
 {
-    itype v1,v2, pos=-1;
     coord_type totang = 0.0;
     coord_type curva;
 
-    bool is_border = false;
-    ivect vt = mesh.VT(v,is_border);
+    //an isolated vertex (VTstar == -1) cannot happen if the mesh has no isolated vertices
+    if (mesh.get_VTstar(v) == -1) return 0.0;
 
-    //t==-1 cannot happen if the mesh has no isolated vertices
-    if (vt.size() == 0) return 0.0;
-
-    for(auto t : vt)
+    // a single visit of the star collects both the angles and the mixed area
+    coord_type area = 0.0;
+    Star_Triangle st;
+    bool is_border;
+    mesh.VT(v,buffers.vt,is_border);
+    dvect &angles = buffers.values;
+    angles.resize(buffers.vt.size());
+    for(utype i=0; i<buffers.vt.size(); i++)
     {
-        Triangle &current = mesh.get_triangle(t);
-        pos = current.vertex_index(v);
-        v1 = current.TV((pos+1)%current.vertices_num());
-        v2 = current.TV((pos+2)%current.vertices_num());
-        coord_type res = Geometry_Curvature::cos_angle(mesh.get_vertex(v1),mesh.get_vertex(v),mesh.get_vertex(v2));
-        totang += acos(res);
+        Geometry_Curvature::star_triangle(v,buffers.vt[i],mesh,st);
+        angles[i] = st.cos_v;
+        if (this->divide_by_area)
+            area += Geometry_Curvature::voronoi_barycentric_area(st,mesh);
     }
+    // the angles of the star are computed in a batch
+    trig_kernels::acos(angles.data(),angles.data(),angles.size());
+    for(auto ang : angles)
+        totang += ang;
 
     if(is_border)
         curva = PI-totang; // boundary vertex
@@ -54,8 +60,53 @@ coord_type ConcentratedCurvature::compute(itype v, Spatial_Mesh &mesh)
         curva = 2.0*PI-totang;   // interior vertex
 
     if (this->divide_by_area) // gaussian angle deficit
-        curva /= Geometry_Curvature::voronoi_barycentric_area(v,mesh);
+        curva /= area;
     // else concentrated curvature
 
     return curva;
 }
+
+void ConcentratedCurvature::compute_values_scatter(Spatial_Mesh &mesh)
+{
+    Triangle_Scatter scatter;
+    scatter.compute(mesh,false);
+
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<mesh.get_vertices_num(); v++)
+    {
+        coord_type curva = 0.0;
+        if(scatter.is_incident(v))
+        {
+            if(scatter.is_border(v))
+                curva = PI-scatter.get_angle_sum(v); // boundary vertex
+            else
+                curva = 2.0*PI-scatter.get_angle_sum(v); // interior vertex
+
+            if (this->divide_by_area) // gaussian angle deficit
+                curva /= scatter.get_mixed_area(v);
+        }
+        curvature[v] = curva;
+    }
+}
+
+void ConcentratedCurvature::compute_values_from_stars(Curvature_Stars &stars)
+{
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<(itype)curvature.size(); v++)
+    {
+        coord_type curva = 0.0;
+        if(stars.get_VT_num(v) > 0)
+        {
+            if(stars.is_border(v))
+                curva = PI-stars.get_angle_sum(v); // boundary vertex
+            else
+                curva = 2.0*PI-stars.get_angle_sum(v); // interior vertex
+
+            if (this->divide_by_area) // gaussian angle deficit
+                curva /= stars.get_mixed_area(v);
+        }
+        curvature[v] = curva;
+    }
+}
+
+template class Curvature_Estimator<ConcentratedCurvature>;
@@ -26,15 +26,25 @@
 #define CONCENTRATEDCURVATURE_H
 
 #include "abstract_curvature.h"
+#include "triangle_scatter.h"
+#include "curvature_stars.h"
 
-class ConcentratedCurvature : public AbstractCurvature
+class ConcentratedCurvature : public Curvature_Estimator<ConcentratedCurvature>
 {
+    friend class Curvature_Estimator<ConcentratedCurvature>;
+
 public:
-    ConcentratedCurvature(bool div_by_area, Spatial_Mesh &mesh) : AbstractCurvature(mesh,div_by_area) {}
+    ConcentratedCurvature(bool div_by_area, Spatial_Mesh &mesh) : Curvature_Estimator(mesh,div_by_area) {}
+    //compute for all vertices, visiting each triangle once (see Triangle_Scatter) instead of the star of each vertex
+    void compute_values_scatter(Spatial_Mesh &mesh);
+    //compute for all vertices, from the quantities collected by a visit of the stars shared with other estimators
+    void compute_values_from_stars(Curvature_Stars &stars);
 
 protected:
     //curvature estimation function: mean angle deficit
-    coord_type compute(itype v, Spatial_Mesh &mesh);
+    coord_type compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers);
 };
 
+extern template class Curvature_Estimator<ConcentratedCurvature>;
+
 #endif // CONCENTRATEDCURVATURE_H
@@ -0,0 +1,159 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "curvature_stars.h"
+#include "mean_curvature.h"
+#include "utilities/parallel.h"
+#include "utilities/trig_kernels.h"
+
+void Curvature_Stars::compute(Spatial_Mesh &mesh)
+{
+    itype num_v = mesh.get_vertices_num();
+    // the normals of the vertices, if not computed yet, are a by-product of the visit of the stars
+    // (with the same angles and order of Normal_Field::compute_vertex_normals)
+    normals = &mesh.get_normal_field(false);
+    with_normals = !normals->has_vertex_normals();
+    if(with_normals)
+        normals->reset_vertex_normals(num_v);
+
+    vt_offsets.assign(num_v+1,0);
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<mesh.get_triangles_num(); t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        for(int i=0; i<tr.vertices_num(); i++)
+        {
+            #pragma omp atomic
+            vt_offsets[tr.TV(i)+1]++;
+        }
+    }
+    // the cost of a vertex is estimated by the number of its incident triangles
+    ivect cost(num_v);
+    for(itype v=0; v<num_v; v++)
+    {
+        cost[v] = 1 + vt_offsets[v+1];
+        vt_offsets[v+1] += vt_offsets[v];
+    }
+    parallel::balanced_chunks(cost,16,limits);
+
+    vt.resize(vt_offsets[num_v]);
+    vv.resize(vt_offsets[num_v]+num_v);
+    angle_sum.assign(num_v,0);
+    mixed_area.assign(num_v,0);
+    laplacian.assign(num_v,Vec3());
+    border.assign(num_v,0);
+
+    #pragma omp parallel
+    {
+        dvect angles;
+        #pragma omp for schedule(dynamic,1)
+        for(itype c=0; c<(itype)limits.size()-1; c++)
+        {
+            for(itype v=limits[c]; v<limits[c+1]; v++)
+                visit(v,mesh,angles);
+        }
+    }
+    if(with_normals)
+        normals->validate_vertex_normals();
+}
+
+void Curvature_Stars::visit(itype v, Spatial_Mesh &mesh, dvect &angles)
+{
+    //an isolated vertex (VTstar == -1) cannot happen if the mesh has no isolated vertices
+    if (mesh.get_VTstar(v) == -1) return;
+
+    itype *star = get_VT(v);
+    itype *ring = get_VV(v);
+    itype n = 0, m = 0;
+
+    // the sums follow the order of the star visit, as in the estimators
+    coord_type totang = 0.0, area = 0.0;
+    Vec3 summation, vnorm;
+    coord_type normal_angles = 0.0;
+    Star_Triangle first, pred, current;
+    bool reversed = false;
+    angles.clear();
+    StarIterator<Vertex> it(mesh,v);
+    for(; !it.end(); ++it)
+    {
+        Geometry_Curvature::star_triangle(v,*it,mesh,current,true);
+        star[n++] = current.t;
+
+        angles.push_back(current.cos_v);
+        if(with_normals)
+        {
+            coord_type ang = acos(current.cos_v);
+            normal_angles += ang;
+            vnorm += normals->get_triangle_normal(current.t) * ang;
+        }
+        area += Geometry_Curvature::voronoi_barycentric_area(current,mesh);
+        Triangle tr = mesh.get_triangle(current.t);
+
+        if(it.get_pred() == -1)
+        {
+            first = current;
+            ring[m++] = current.b;
+        }
+        else
+        {
+            // on the border the visit restarts from the first triangle, in the opposite direction
+            if(it.is_border() && !reversed)
+            {
+                reversed = true;
+                ring[m++] = first.a;
+            }
+            int k = tr.vertex_index(v);
+            ring[m++] = (tr.TT((k+1)%3) == it.get_pred()) ? current.a : current.b;
+
+            MeanCurvature::triangle_pair_contrib(v,(it.get_pred() == pred.t) ? pred : first,current,summation,mesh);
+        }
+        pred = current;
+    }
+    if(it.is_border() && !reversed)
+        ring[m++] = first.a;
+    // around an interior vertex the last and the first triangle form the closing pair
+    if(!it.is_border() && pred.t != first.t)
+        MeanCurvature::triangle_pair_contrib(v,pred,first,summation,mesh);
+
+    // the angles of the star are computed in a batch, with the kernel of ConcentratedCurvature
+    trig_kernels::acos(angles.data(),angles.data(),angles.size());
+    for(auto ang : angles)
+        totang += ang;
+
+    if(with_normals)
+        normals->set_vertex_normal(v,Normal_Field::vertex_normal(vnorm,n,normal_angles));
+
+    angle_sum[v] = totang;
+    mixed_area[v] = area;
+    border[v] = it.is_border();
+    laplacian[v] = summation;
+}
+
+size_t Curvature_Stars::get_storage_size()
+{
+    return sizeof(coord_type) * (angle_sum.capacity() + mixed_area.capacity()) +
+            sizeof(Vec3) * laplacian.capacity() +
+            sizeof(char) * border.capacity() +
+            sizeof(itype) * (vt_offsets.capacity() + vt.capacity() + vv.capacity() + limits.capacity());
+}
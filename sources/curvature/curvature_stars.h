@@ -0,0 +1,85 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CURVATURE_STARS_H
+#define CURVATURE_STARS_H
+
+#include "ia/mesh.h"
+#include "geometry_curvature.h"
+
+//computes, with a single visit of the star of each vertex, the per-vertex quantities shared by the
+//curvature estimators: angle sums, mixed (Voronoi-barycentric) areas, border flags,
+//the cotangent-Laplacian vectors (as paired by the Mean Curvature) and the VT and VV relations.
+//the values are identical to the ones computed by each estimator visiting the stars on its own.
+class Curvature_Stars
+{
+public:
+    Curvature_Stars() { normals = NULL; with_normals = false; }
+
+    //visit the stars of all the vertices (in parallel, on chunks of vertices with a similar number of incident triangles)
+    void compute(Spatial_Mesh &mesh);
+
+    inline coord_type get_angle_sum(itype v) { return angle_sum[v]; }
+    inline coord_type get_mixed_area(itype v) { return mixed_area[v]; }
+    //the normal of v, as the sum of the normals of the incident triangles weighted by their angle in v (unit length),
+    //from the normals of the mesh (see Normal_Field), computed by compute if the mesh has not them yet
+    inline const Vec3& get_normal(itype v) { return normals->get_vertex_normal(v); }
+    //the contributions of the pairs of consecutive triangles around v (see MeanCurvature::triangle_pair_contrib)
+    inline Vec3& get_laplacian(itype v) { return laplacian[v]; }
+    inline bool is_border(itype v) { return border[v]; }
+
+    //the triangles incident in v, in the order of the star visit
+    inline itype get_VT_num(itype v) { return vt_offsets[v+1]-vt_offsets[v]; }
+    inline itype* get_VT(itype v) { return &vt[vt_offsets[v]]; }
+    //the vertices adjacent to v, in the same order of Mesh::VV
+    inline itype get_VV_num(itype v) { return get_VT_num(v)+border[v]; }
+    inline itype* get_VV(itype v) { return &vv[vt_offsets[v]+v]; }
+
+    //the chunks of vertices with a similar number of incident triangles, the chunk c contains the vertices in [limits[c],limits[c+1])
+    inline ivect& get_chunks() { return limits; }
+
+    //storage (in bytes) of the shared quantities
+    size_t get_storage_size();
+
+protected:
+    dvect angle_sum;
+    dvect mixed_area;
+    Normal_Field *normals;
+    //true if the visit computes the normals of the vertices
+    bool with_normals;
+    vector<Vec3> laplacian;
+    vector<char> border;
+
+    //VT in CSR format, the VV of v starts at vt_offsets[v]+v as each VV has at most one more vertex than VT
+    ivect vt_offsets;
+    ivect vt;
+    ivect vv;
+
+    ivect limits;
+
+    //visit the star of v (angles is a buffer of the thread)
+    void visit(itype v, Spatial_Mesh &mesh, dvect &angles);
+};
+
+#endif // CURVATURE_STARS_H
@@ -25,15 +25,9 @@
 #include "geometry_curvature.h"
 
 //compute cosinus of angle formed by 3 vertices
-coord_type Geometry_Curvature::cos_angle(Vertex &v1, Vertex &v2, Vertex &v3)
+coord_type Geometry_Curvature::cos_angle(const Vec3 &v1, const Vec3 &v2, const Vec3 &v3)
 {
-    coord_type norm21=v2.norm(v1);
-    coord_type norm23=v2.norm(v3);
-    coord_type product=v2.scalar_product(v1,v3);
-    coord_type costeta=product/(norm21*norm23);
-    if (costeta>1.0) costeta = 1.0;
-    if (costeta<-1.0) costeta = -1.0;
-    return costeta;
+    return Normal_Field::cos_angle(v1,v2,v3);
 }
 
 //compute total area of triangles incident in v
@@ -43,7 +37,8 @@ coord_type Geometry_Curvature::fan_area(ivect& vt, Spatial_Mesh &mesh)
 
     for(utype i=0;i<vt.size();i++)
     {
-        a += triangle_area(mesh.get_triangle(vt[i]),mesh);
+        Triangle t = mesh.get_triangle(vt[i]);
+        a += triangle_area(t,mesh);
     }
 
     return a;
@@ -58,13 +53,13 @@ coord_type Geometry_Curvature::triangle_area(Triangle& t, Spatial_Mesh &mesh)
     coord_type cosalpha;
     coord_type senalpha;
 
-    Vertex &v1 = mesh.get_vertex(t.TV(0));
-    Vertex &v2 = mesh.get_vertex(t.TV(1));
-    Vertex &v3 = mesh.get_vertex(t.TV(2));
+    Vec3 v1 = mesh.get_vertex(t.TV(0));
+    Vec3 u = Vec3(mesh.get_vertex(t.TV(1))) - v1;
+    Vec3 v = Vec3(mesh.get_vertex(t.TV(2))) - v1;
 
-    prodscaluv=v1.scalar_product(v2,v3);
-    normau=v1.norm(v2);
-    normav=v1.norm(v3);
+    prodscaluv=u.dot(v);
+    normau=u.norm();
+    normav=v.norm();
     cosalpha = prodscaluv / (normau*normav);
     senalpha=sqrt(1-(cosalpha*cosalpha));
     if(std::isnan(senalpha)) senalpha=0.0001;
@@ -72,25 +67,9 @@ coord_type Geometry_Curvature::triangle_area(Triangle& t, Spatial_Mesh &mesh)
     return (normau*normav*senalpha)/2;
 }
 
-void Geometry_Curvature::triangle_normal(Triangle &t, Vertex &tnorm, Spatial_Mesh &mesh)
+Vec3 Geometry_Curvature::triangle_normal(Triangle &t, Spatial_Mesh &mesh)
 {
-    Vertex &v1 = mesh.get_vertex(t.TV(0));
-    Vertex &v2 = mesh.get_vertex(t.TV(1));
-    Vertex &v3 = mesh.get_vertex(t.TV(2));
-
-    coord_type a[3], b[3];
-    coord_type norm=0;
-
-    for(int i=0; i < v1.get_dimension(); i++)
-    {
-        a[i] = v1.get_c(i)-v2.get_c(i);
-        b[i] = v1.get_c(i)-v3.get_c(i);
-    }
-
-    tnorm = Vertex(a[1]*b[2] - a[2]*b[1], a[2]*b[0] - a[0]*b[2], a[0]*b[1] - a[1]*b[0]);
-
-    norm = tnorm.norm();
-    tnorm /= norm;
+    return Normal_Field::triangle_normal(mesh.get_vertex(t.TV(0)),mesh.get_vertex(t.TV(1)),mesh.get_vertex(t.TV(2)));
 }
 
 //test if segment v1-v2 intersect plane of equation
@@ -99,14 +78,10 @@ void Geometry_Curvature::triangle_normal(Triangle &t, Vertex &tnorm, Spatial_Mes
 // 1 : intersection is v1
 // 2 : intersection is v2
 // 3 : proper intersection
-int Geometry_Curvature::intersect_plane(Vertex &v1, Vertex &v2, dvect &abc, Vertex &v)
+int Geometry_Curvature::intersect_plane(const Vec3 &v1, const Vec3 &v2, const Vec3 &abc, const Vec3 &v)
 {
-    coord_type res1=0, res2=0;
-    for(int i=0; i < v1.get_dimension(); i++)
-    {
-        res1 += abc[i]*(v1.get_c(i)-v.get_c(i));
-        res2 += abc[i]*(v2.get_c(i)-v.get_c(i));
-    }
+    coord_type res1 = abc.dot(v1-v);
+    coord_type res2 = abc.dot(v2-v);
 
     if ((-TOLER<=res1)&&(res1<=TOLER)) return 1;
     if ((-TOLER<=res2)&&(res2<=TOLER)) return 2;
@@ -115,67 +90,63 @@ int Geometry_Curvature::intersect_plane(Vertex &v1, Vertex &v2, dvect &abc, Vert
     return 0;
 }
 
-int Geometry_Curvature::same_point(Vertex &p1, Vertex &p2)
+int Geometry_Curvature::same_point(const Vec3 &p1, const Vec3 &p2)
 {
-    for(int i=0; i < p1.get_dimension(); i++)
-        if (fabs(p1.get_c(i)-p2.get_c(i))>SMALL_TOLER)
-            return 0;
+    if (fabs(p1.x-p2.x)>SMALL_TOLER || fabs(p1.y-p2.y)>SMALL_TOLER || fabs(p1.z-p2.z)>SMALL_TOLER)
+        return 0;
     return 1;
 }
 
+//Intersect the edge v1-v2, opposite to v in a triangle not incident in w,
+//with the plane through v and w of coefficients abc: returns false if
+//there is no intersection, or if it is w itself.
+bool Geometry_Curvature::edge_plane_intersection(const Vec3 &v1, const Vec3 &v2, const Vec3 &v, const Vec3 &w, const Vec3 &abc, Vec3 &w1)
+{
+    if (Geometry_Curvature::same_point(v1,w) || Geometry_Curvature::same_point(v2,w))
+        return false;
+
+    switch(Geometry_Curvature::intersect_plane(v1,v2,abc,v))
+    {
+    case 1: // intersection is v1
+        w1 = v1;
+        break;
+    case 2: // intersection is v2
+        w1 = v2;
+        break;
+    case 3: // proper intersection, compute intersection
+    {
+        coord_type d = ((-abc)*v1 + abc*v).sum();
+        coord_type n = (abc*v2 - abc*v1).sum();
+        coord_type s = d / n;
+        w1 = (v2-v1)*s + v1;
+        break;
+    }
+    default:
+        return false;
+    }
+
+    // se ho trovato w stesso devo cercare l'altro punto di intersezione
+    return !same_point(w1,w);
+}
+
 //Find the triangle, around V v, that is intersected by the plane through
 //v, the normal vnorm to v, and point w, the equation of such plane is
 //a(x-vx)+b(y-vy)+c(z-vz)=0 dove v=(vx,vy,vz):
 //compute the intersection point and return it.
-Vertex Geometry_Curvature::find_plane_intersection(itype v_id, Vertex &v, ivect &vt, Vertex &vnorm, Vertex &w, dvect &abc, Spatial_Mesh &mesh)
+Vec3 Geometry_Curvature::find_plane_intersection(itype v_id, const Vec3 &v, ivect &vt, const Vec3 &vnorm, const Vec3 &w, const Vec3 &abc, Spatial_Mesh &mesh)
 {
-    //    int t1;
     bool found = false;
-    itype v1_id, v2_id;
-    Vertex w1;
+    Vec3 w1;
 
     for(ivect_iter it=vt.begin(); it!=vt.end(); ++it)
     {
-        Triangle &t = mesh.get_triangle(*it);
+        Triangle t = mesh.get_triangle(*it);
         int v_pos = t.vertex_index(v_id);
 
-        v1_id = t.TV((v_pos+1)%t.vertices_num());
-        v2_id = t.TV((v_pos+2)%t.vertices_num());
-        Vertex &v1 = mesh.get_vertex(v1_id);
-        Vertex &v2 = mesh.get_vertex(v2_id);
-
-        if ( !Geometry_Curvature::same_point(v1,w) && !Geometry_Curvature::same_point(v2,w) )
-        {
-            switch(Geometry_Curvature::intersect_plane(v1,v2,abc,v))
-            {
-            case 1: // intersection is v1
-                w1 = v1;
-                found = true;
-                break;
-            case 2: // intersection is v2
-                w1 = v2;
-                found = true;
-                break;
-            case 3: // proper intersection, compute intersection
-                coord_type d=0,n=0;
-                for(int i=0; i < v.get_dimension(); i++)
-                {
-                    d += -abc[i]*v1.get_c(i) + abc[i]*v.get_c(i);
-                    n +=  abc[i]*v2.get_c(i) - abc[i]*v1.get_c(i);
-                }
-                coord_type s = d / n;
-                w1 = Vertex(v.get_dimension());
-                for(int i=0; i < v1.get_dimension(); i++)
-                    w1.set_c(i,s*(v2.get_c(i)-v1.get_c(i)) + v1.get_c(i));
-                found = true;
-                break;
-            }
-
-            // se ho trovato w stesso devo cercare l'altro punto di intersezione
-            if (found && same_point(w1,w))
-                found = false;
-        }
+        Vec3 v1 = mesh.get_vertex(t.TV((v_pos+1)%t.vertices_num()));
+        Vec3 v2 = mesh.get_vertex(t.TV((v_pos+2)%t.vertices_num()));
 
+        found = Geometry_Curvature::edge_plane_intersection(v1,v2,v,w,abc,w1);
         if(found)
             break;
     }
@@ -185,9 +156,7 @@ Vertex Geometry_Curvature::find_plane_intersection(itype v_id, Vertex &v, ivect
         // and not found an edge which intersects...
     {
         // simulate a vertical wall
-        w1 = Vertex(v.get_dimension());
-        for(int i=0; i < v.get_dimension(); i++)
-            w1.set_c(i,v.get_c(i)-vnorm.get_c(i));
+        w1 = v - vnorm;
     }
 
     return w1;
@@ -199,69 +168,75 @@ Vertex Geometry_Curvature::find_plane_intersection(itype v_id, Vertex &v, ivect
 coord_type Geometry_Curvature::voronoi_barycentric_area(itype v, Spatial_Mesh &mesh)
 {
     coord_type a = 0.0;
-    itype pred = -1;
-    itype current = mesh.get_vertex(v).get_VTstar();
-    a += voronoi_barycentric_area(v, current, mesh);
-
-    itype k = mesh.get_triangle(current).vertex_index(v);
+    mesh.for_each_VT(v,[&](itype t){ a += voronoi_barycentric_area(v, t, mesh); });
+    return a;
+}
 
-    //choose one side to visit
-    pred = current;
-    current = mesh.get_triangle(current).TT((k+1)%3);
+//compute edge lengths and angles of triangle t around vertex v.
+//the values are the same (bit by bit) of the ones computed by norm and cos_angle,
+//but the differences among the vertices are computed once
+void Geometry_Curvature::star_triangle(itype v, itype t, Spatial_Mesh &mesh, Star_Triangle &st, bool with_cotangents)
+{
+    Triangle tr = mesh.get_triangle(t);
+    int i = tr.vertex_index(v);
+    st.t = t;
+    st.a = tr.TV((i+1)%3);
+    st.b = tr.TV((i+2)%3);
+
+    Vec3 vert = mesh.get_vertex(v);
+    Vec3 vert_a = mesh.get_vertex(st.a);
+    Vec3 vert_b = mesh.get_vertex(st.b);
+
+    Vec3 ea = vert_a - vert; // a-v
+    Vec3 eb = vert_b - vert; // b-v
+    Vec3 eab = vert_b - vert_a; // b-a
+
+    coord_type sq_a = ea.squared_norm(), sq_b = eb.squared_norm(), sq_ab = eab.squared_norm();
+    coord_type dot_v = ea.dot(eb), dot_a = (-ea).dot(eab), dot_b = eab.dot(eb);
+    st.len_a = sqrt(sq_a);
+    st.len_b = sqrt(sq_b);
+    st.len_ab = sqrt(sq_ab);
+
+    st.cos_v = dot_v/(st.len_a*st.len_b);
+    st.cos_a = dot_a/(st.len_a*st.len_ab);
+    st.cos_b = dot_b/(st.len_ab*st.len_b);
+
+    coord_type *cosinus[3] = { &st.cos_v, &st.cos_a, &st.cos_b };
+    for(int c=0; c<3; c++)
+    {
+        if (*cosinus[c]>1.0) *cosinus[c] = 1.0;
+        if (*cosinus[c]<-1.0) *cosinus[c] = -1.0;
+    }
 
-    bool is_border = false;
-    while(current != mesh.get_vertex(v).get_VTstar())
+    st.with_cotangents = with_cotangents;
+    if(with_cotangents)
     {
-        if(current == -1) // border
-        {
-            if(is_border) // if it is the second time that I get to a border I exit
-                break;
-            else
-            {
-                // otherwise I hit a triangle on the border for the first time
-                // then, I visit in the opposite direction starting again from VTstar
-                is_border = true;
-                pred = mesh.get_vertex(v).get_VTstar();
-                k = mesh.get_triangle(pred).vertex_index(v);
-                current = mesh.get_triangle(pred).TT((k+2)%3);
-                if(current==-1) // no need visit the star in the opposite direction
-                    break;
-            }
-        }
-
-        a += voronoi_barycentric_area(v, current, mesh);
-        mesh.get_triangle(current).next_triangle_around_v(v,current,pred);
+        st.cot_a = cotangent(st.cos_a);
+        st.cot_b = cotangent(st.cos_b);
     }
-    return a;
 }
 
 //compute the contribution of triangle t to the mixed area around
 //vertex v, where v is a vertex of t.
-//the contribution of t is the Voronoi area if
-//all angles are acute, or the barycentric area otherwise
 coord_type Geometry_Curvature::voronoi_barycentric_area(itype v, itype t, Spatial_Mesh &mesh)
 {
-    itype i, v1, v2;
-    coord_type cos_a, cos_b, cos_c;
-
-    Triangle &tr = mesh.get_triangle(t);
+    Star_Triangle st;
+    star_triangle(v,t,mesh,st);
+    return voronoi_barycentric_area(st,mesh);
+}
 
-    // triangle t is v v1 v2
+//compute the contribution of triangle t to the mixed area around
+//vertex v, where v is a vertex of t.
+//the contribution of t is the Voronoi area if
+//all angles are acute, or the barycentric area otherwise
+coord_type Geometry_Curvature::voronoi_barycentric_area(Star_Triangle &st, Spatial_Mesh &mesh)
+{
     // a,b,c are the angles in v, v1, v2
-    i = tr.vertex_index(v);
-    v1 = tr.TV((i+1)%3);
-    v2 = tr.TV((i+2)%3);
-
-    Vertex &vert = mesh.get_vertex(v);
-    Vertex &vert1 = mesh.get_vertex(v1);
-    Vertex &vert2 = mesh.get_vertex(v2);
-
-    cos_a = Geometry_Curvature::cos_angle(vert2,vert,vert1);
-    cos_b = Geometry_Curvature::cos_angle(vert,vert1,vert2);
-    cos_c = Geometry_Curvature::cos_angle(vert1,vert2,vert);
+    coord_type cos_a = st.cos_v, cos_b = st.cos_a, cos_c = st.cos_b;
 
     if ((cos_a<0.0)||(cos_b<0.0)||(cos_c<0.0)) // one is obtuse
     {
+        Triangle tr = mesh.get_triangle(st.t);
         if (cos_a<0.0) // the obtuse angle is in v
             return 0.5 * Geometry_Curvature::triangle_area(tr,mesh);
         else
@@ -269,19 +244,16 @@ coord_type Geometry_Curvature::voronoi_barycentric_area(itype v, itype t, Spatia
     }
     else // Voronoi area
     {
-        coord_type sin_b, cot_b, sin_c, cot_c, e1, e2;
+        coord_type cot_b, cot_c, e1, e2;
         /* if angles are zero area is zero */
         if (cos_b==1.0) return 0.0;
         if (cos_c==1.0) return 0.0;
 
-        sin_b = sin(acos(cos_b));
-        sin_c = sin(acos(cos_c));
-
-        cot_b = cos_b / sin_b;
-        cot_c = cos_c / sin_c;
+        cot_b = (st.with_cotangents) ? st.cot_a : cotangent(cos_b);
+        cot_c = (st.with_cotangents) ? st.cot_b : cotangent(cos_c);
 
-        e1 = vert1.norm(vert);
-        e2 = vert2.norm(vert);
+        e1 = st.len_a;
+        e2 = st.len_b;
         return (cot_c*e1*e1 + cot_b*e2*e2) / 8.0;
     }
 }
@@ -27,6 +27,7 @@
 
 #include "utilities/basic_wrappers.h"
 #include "ia/mesh.h"
+#include "ia/vec.h"
 
 #define TOLER (0.3e-6)
 #define SMALL_TOLER (0.3e-10)
@@ -35,34 +36,55 @@
 #define PI 3.14159265358979323846
 #endif
 
+///the geometric quantities of a triangle t incident in a vertex v, whose other vertices are a and b (following the triangle order)
+struct Star_Triangle
+{
+    itype t, a, b;
+    coord_type len_a, len_b, len_ab; // lengths of the edges v-a, v-b and a-b
+    coord_type cos_v, cos_a, cos_b; // cosinus of the angles in v, a and b (as computed by cos_angle)
+    coord_type cot_a, cot_b; // cotangents of the angles in a and b (only if requested to star_triangle)
+    bool with_cotangents;
+};
+
 class Geometry_Curvature
 {
 public:
     Geometry_Curvature() {}
 
     //compute cosinus of angle formed by 3 vertices
-    static coord_type cos_angle(Vertex& v1, Vertex& v2, Vertex& v3);
+    static coord_type cos_angle(const Vec3 &v1, const Vec3 &v2, const Vec3 &v3);
     //compute total area of triangles incident in v
     static coord_type fan_area(ivect &vt, Spatial_Mesh &mesh);
     //compute triangle area
     static coord_type triangle_area(Triangle& t, Spatial_Mesh& mesh);
-    //compute triangle normal
-    static void triangle_normal(Triangle &t, Vertex &tnorm, Spatial_Mesh &mesh);
+    //compute triangle normal (unit length)
+    static Vec3 triangle_normal(Triangle &t, Spatial_Mesh &mesh);
     //test if segment v1-v2 intersect plane of equation:
     // a(x-vx)+b(y-vy)+c(z-vz)=0 where v=(vx,vy,vz)
-    static int intersect_plane(Vertex &v1, Vertex &v2, dvect &abc, Vertex &v);
+    static int intersect_plane(const Vec3 &v1, const Vec3 &v2, const Vec3 &abc, const Vec3 &v);
+    //intersect the edge v1-v2 opposite to v with the plane through v and w of coefficients abc,
+    //returns false if there is no intersection or if it is w itself (the intersection is set in w1)
+    static bool edge_plane_intersection(const Vec3 &v1, const Vec3 &v2, const Vec3 &v, const Vec3 &w, const Vec3 &abc, Vec3 &w1);
     //Find the triangle, around V v, that is intersected by the plane through
     //v, the normal vnorm to v, and point w, the equation of such plane is
     //a(x-vx)+b(y-vy)+c(z-vz)=0 dove v=(vx,vy,vz):
     //compute the intersection point and return it.
-    static Vertex find_plane_intersection(itype v_id, Vertex &v, ivect &vt, Vertex &vnorm, Vertex &w, dvect &abc, Spatial_Mesh &mesh);
-    static int same_point(Vertex &p1, Vertex &p2);
+    static Vec3 find_plane_intersection(itype v_id, const Vec3 &v, ivect &vt, const Vec3 &vnorm, const Vec3 &w, const Vec3 &abc, Spatial_Mesh &mesh);
+    static int same_point(const Vec3 &p1, const Vec3 &p2);
+
+    //compute edge lengths and angles (and, if requested, the cotangents in the vertices opposite to v)
+    //of triangle t around vertex v, in a single pass on its vertices
+    static void star_triangle(itype v, itype t, Spatial_Mesh &mesh, Star_Triangle &st, bool with_cotangents=false);
+    //compute the cotangent of an angle from its cosinus
+    static inline coord_type cotangent(coord_type cos_angle) { return cos_angle / sin(acos(cos_angle)); }
 
     //compute the mixed (Voronoi-barycentric) area around vertex v
     static coord_type voronoi_barycentric_area(itype v, Spatial_Mesh &mesh);
     //compute either the Voronoi area (if all angles of t are acute) or the
     //barycentric area (otherwise) of triangle t centered in its vertex v
     static coord_type voronoi_barycentric_area(itype v, itype t, Spatial_Mesh &mesh);
+    //as above, reusing the quantities of the triangle already computed by star_triangle
+    static coord_type voronoi_barycentric_area(Star_Triangle &st, Spatial_Mesh &mesh);
 };
 
 
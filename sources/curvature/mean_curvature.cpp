@@ -26,57 +26,43 @@
 #include "geometry_curvature.h"
 
 //function for computing mean angle deficit curvature at vertex v
-coord_type MeanCurvature::compute(itype v, Spatial_Mesh &mesh)
+inline coord_type MeanCurvature::compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &)
 {
-    Vertex summation = Vertex(3);
+    Vec3 summation;
     coord_type curva;
 
-    itype pred = -1;
-    itype current = mesh.get_vertex(v).get_VTstar();
-
-    itype k = mesh.get_triangle(current).vertex_index(v);
-
-    //choose one side to visit
-    pred = current;
-    current = mesh.get_triangle(current).TT((k+1)%3);
-
-    bool is_border = false;
-    while(current != mesh.get_vertex(v).get_VTstar())
+    // a single visit of the star collects the contributions of the pairs of
+    // consecutive triangles (i.e., of the edges shared by two triangles of the star)
+    // and the mixed area (the first triangle is kept as, on the border, the visit
+    // restarts from it, and it closes the star of an interior vertex)
+    coord_type Atot = 0.0;
+    Star_Triangle first, pred, current;
+    StarIterator<Vertex> it(mesh,v);
+    for(; !it.end(); ++it)
     {
-        if(current != -1)
-        {
-            triangle_pair_contrib(v,pred,current,summation,mesh);
-            mesh.get_triangle(current).next_triangle_around_v(v,current,pred);
-        }
-        else if(current == -1) // border
-        {
-            if(is_border) // if it is the second time that I get to a border I exit
-                break;
-            else
-            {
-                // otherwise I hit a triangle on the border for the first time
-                // then, I visit in the opposite direction starting again from VTstar
-                is_border = true;
-                pred = mesh.get_vertex(v).get_VTstar();
-                k = mesh.get_triangle(pred).vertex_index(v);
-                current = mesh.get_triangle(pred).TT((k+2)%3);
-                if(current==-1) // no need visit the star in the opposite direction
-                    break;
-            }
-        }
+        Geometry_Curvature::star_triangle(v,*it,mesh,current,true);
+        if (this->divide_by_area)
+            Atot += Geometry_Curvature::voronoi_barycentric_area(current,mesh);
+
+        if(it.get_pred() == -1)
+            first = current;
+        else
+            triangle_pair_contrib(v,(it.get_pred() == pred.t) ? pred : first,current,summation,mesh);
+        pred = current;
     }
+    // around an interior vertex the last and the first triangle form the closing pair
+    if(!it.is_border() && pred.t != first.t)
+        triangle_pair_contrib(v,pred,first,summation,mesh);
 
     if (this->divide_by_area)
     {
-        coord_type Atot = Geometry_Curvature::voronoi_barycentric_area(v,mesh);
-
         if(Atot>0.00001)//approximation error
         {
             summation /= (2*Atot);
         }
         else
         {
-            summation = Vertex(3);
+            summation = Vec3();
         }
     }
     else
@@ -90,39 +76,54 @@ coord_type MeanCurvature::compute(itype v, Spatial_Mesh &mesh)
 }
 
 
+//returns the cosinus (and the cotangent) of the angle in vertex x of the triangle v x w,
+//reusing the values of st if it is such triangle
+static inline coord_type corner_cos(itype v, itype x, itype w, Star_Triangle &st, coord_type &cot, Spatial_Mesh &mesh)
+{
+    if(x == st.a && w == st.b)
+    {
+        cot = st.cot_a;
+        return st.cos_a;
+    }
+    if(x == st.b && w == st.a)
+    {
+        cot = st.cot_b;
+        return st.cos_b;
+    }
+    coord_type cos_x = Geometry_Curvature::cos_angle(mesh.get_vertex(v),mesh.get_vertex(x),mesh.get_vertex(w));
+    cot = Geometry_Curvature::cotangent(cos_x);
+    return cos_x;
+}
+
 //compute contribution of a pair of consecutive triangles incident
 //in vertex v, and put the contribution in vector somma
-void MeanCurvature::triangle_pair_contrib(itype v, itype t, itype tnext, Vertex &summation, Spatial_Mesh &mesh)
+void MeanCurvature::triangle_pair_contrib(itype v, Star_Triangle &tr, Star_Triangle &tr_next, Vec3 &summation, Spatial_Mesh &mesh)
 {
-    itype i, inext;
     itype w, v1, v2;
-    coord_type cos_a, sin_a, cot_a;
-    coord_type cos_b, sin_b, cot_b;
-
-    Vertex &vert = mesh.get_vertex(v);
+    coord_type cos_a, cot_a;
+    coord_type cos_b, cot_b;
 
-    Triangle &tr = mesh.get_triangle(t);
-    Triangle &tr_next = mesh.get_triangle(tnext);
+    Vec3 vert = mesh.get_vertex(v);
 
-    i = tr.vertex_index(v);
-    inext = tr_next.vertex_index(v);
-    w = tr.TV((i+1)%3);
-    v1 = tr.TV((i+2)%3);
-    v2 = tr_next.TV((inext+1)%3);
+    w = tr.a;
+    v1 = tr.b;
+    v2 = tr_next.a;
 
     if(v2==v1) //se sono uguali inverto l'ordine dei due triangoli
     {
-        w = tr_next.TV((inext+1)%3);
-        v1 = tr_next.TV((inext+2)%3);
-        v2 = tr.TV((i+1)%3);
+        w = tr_next.a;
+        v1 = tr_next.b;
+        v2 = tr.a;
+        cos_a = corner_cos(v,v1,w,tr_next,cot_a,mesh);
+        cos_b = corner_cos(v,v2,w,tr,cot_b,mesh);
+    }
+    else
+    {
+        cos_a = corner_cos(v,v1,w,tr,cot_a,mesh);
+        cos_b = corner_cos(v,v2,w,tr_next,cot_b,mesh);
     }
 
-    Vertex &vert1 = mesh.get_vertex(v1);
-    Vertex &vert2 = mesh.get_vertex(v2);
-    Vertex &vertW = mesh.get_vertex(w);
-
-    cos_a = Geometry_Curvature::cos_angle(vert,vert1,vertW);
-    cos_b = Geometry_Curvature::cos_angle(vert,vert2,vertW);
+    Vec3 vertW = mesh.get_vertex(w);
 
     /* if angle is zero the triangles are degenerate */
     if ( (cos_a==1.0) || (cos_a==-1.0) )
@@ -136,11 +137,58 @@ void MeanCurvature::triangle_pair_contrib(itype v, itype t, itype tnext, Vertex
         return;
     }
 
-    sin_a = sin(acos(cos_a));
-    cot_a = cos_a / sin_a;
+    summation += (vert - vertW) * (cot_a+cot_b);
+}
 
-    sin_b = sin(acos(cos_b));
-    cot_b = cos_b / sin_b;
+//NOTA: the cotangent Laplacian contains the same contributions of compute (the edges shared by two
+//triangles), summed in a different order (thus the values differ only by rounding)
+void MeanCurvature::compute_values_scatter(Spatial_Mesh &mesh)
+{
+    Triangle_Scatter scatter;
+    scatter.compute(mesh,true);
 
-    summation += (vert - vertW) * (cot_a+cot_b);
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<mesh.get_vertices_num(); v++)
+    {
+        Vec3 summation = scatter.get_laplacian(v);
+
+        if (this->divide_by_area)
+        {
+            coord_type Atot = scatter.get_mixed_area(v);
+
+            if(Atot>0.00001)//approximation error
+                summation /= (2*Atot);
+            else
+                summation = Vec3();
+        }
+        else
+            summation /= 2.0;
+
+        curvature[v] = 0.5*(summation.norm());
+    }
+}
+
+void MeanCurvature::compute_values_from_stars(Curvature_Stars &stars)
+{
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<(itype)curvature.size(); v++)
+    {
+        Vec3 summation = stars.get_laplacian(v);
+
+        if (this->divide_by_area)
+        {
+            coord_type Atot = stars.get_mixed_area(v);
+
+            if(Atot>0.00001)//approximation error
+                summation /= (2*Atot);
+            else
+                summation = Vec3();
+        }
+        else
+            summation /= 2.0;
+
+        curvature[v] = 0.5*(summation.norm());
+    }
 }
+
+template class Curvature_Estimator<MeanCurvature>;
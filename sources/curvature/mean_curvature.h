@@ -26,19 +26,30 @@
 #define MEANCURVATURE_H
 
 #include "abstract_curvature.h"
+#include "triangle_scatter.h"
+#include "curvature_stars.h"
+#include "geometry_curvature.h"
 
-class MeanCurvature : public AbstractCurvature
+class MeanCurvature : public Curvature_Estimator<MeanCurvature>
 {
+    friend class Curvature_Estimator<MeanCurvature>;
+
 public:
     //constructor:
-    MeanCurvature(bool div_by_area, Spatial_Mesh &mesh) : AbstractCurvature(mesh,div_by_area) {}
+    MeanCurvature(bool div_by_area, Spatial_Mesh &mesh) : Curvature_Estimator(mesh,div_by_area) {}
+    //compute for all vertices, visiting each triangle once (see Triangle_Scatter) instead of the star of each vertex
+    void compute_values_scatter(Spatial_Mesh &mesh);
+    //compute for all vertices, from the quantities collected by a visit of the stars shared with other estimators
+    void compute_values_from_stars(Curvature_Stars &stars);
+    //compute contribution of a pair of consecutive triangles incident
+    //in vertex v, and put the contribution in vector somma
+    static void triangle_pair_contrib(itype v, Star_Triangle &tr, Star_Triangle &tr_next, Vec3 &summation, Spatial_Mesh &mesh);
 
 protected:
     //curvature estimation function: mean angle deficit
-    coord_type compute(itype v, Spatial_Mesh &mesh);
-    //compute contribution of a pair of consecutive triangles incident
-    //in vertex v, and put the contribution in vector somma
-    void triangle_pair_contrib(itype v, itype t, itype tnext, Vertex &summation, Spatial_Mesh &mesh);
+    coord_type compute(itype v, Spatial_Mesh &mesh, Curvature_Buffers &buffers);
 };
 
+extern template class Curvature_Estimator<MeanCurvature>;
+
 #endif // MEANCURVATURE_H
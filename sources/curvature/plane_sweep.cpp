@@ -0,0 +1,298 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "plane_sweep.h"
+#include "c_curvature.h"
+#include "utilities/timer.h"
+
+bool Plane_Sweep::prepare(itype v, const Vec3 &vert, ivect &vt, const itype *vv, itype vv_num, bool is_border, const Vec3 &vnorm, Spatial_Mesh &mesh)
+{
+    itype d = vt.size();
+    if(d < SWEEP_MIN_DEGREE || vv_num != d+is_border)
+        return false;
+    triangles_num = d;
+    closed = !is_border;
+    center = vert;
+    normal = vnorm;
+
+    first.resize(d);
+    second.resize(d);
+    for(itype k=0; k<d; k++)
+    {
+        Triangle t = mesh.get_triangle(vt[k]);
+        int v_pos = t.vertex_index(v);
+        first[k] = t.TV((v_pos+1)%3);
+        second[k] = t.TV((v_pos+2)%3);
+    }
+
+    // the star visit goes counter-clockwise from VTstar and, on the border, it restarts clockwise from VTstar
+    itype f = 1;
+    while(f < d && first[f] == second[f-1])
+        f++;
+    order.resize(d);
+    vv_pos.resize(vv_num);
+    if(closed)
+    {
+        if(f != d || first[0] != second[d-1])
+            return false;
+        for(itype q=0; q<d; q++)
+        {
+            order[q] = q;
+            vv_pos[q] = (q+1)%d;
+        }
+    }
+    else
+    {
+        for(itype k=f; k<d; k++)
+            if(second[k] != ((k==f) ? first[0] : first[k-1]))
+                return false;
+        for(itype k=f; k<d; k++)
+        {
+            order[d-1-k] = k;
+            vv_pos[k+1] = d-1-k;
+        }
+        for(itype k=0; k<f; k++)
+        {
+            order[d-f+k] = k;
+            vv_pos[k] = d-f+k+1;
+        }
+        vv_pos[f] = d-f;
+    }
+
+    // the ring of vertices around v and the tangent frame
+    ring.resize(d+1);
+    diff.resize(d+1);
+    proj.resize(d+1);
+    angle.resize(d+1);
+    for(itype q=0; q<d; q++)
+        ring[q] = mesh.get_vertex(first[order[q]]);
+    ring[d] = mesh.get_vertex(second[order[d-1]]);
+    for(itype i=0; i<vv_num; i++)
+    {
+        itype q = vv_pos[i];
+        if(vv[i] != ((q < d) ? first[order[q]] : second[order[d-1]]))
+            return false;
+    }
+
+    Vec3 axis(1,0,0);
+    if(fabs(normal.y) <= fabs(normal.x) && fabs(normal.y) <= fabs(normal.z))
+        axis = Vec3(0,1,0);
+    else if(fabs(normal.z) <= fabs(normal.x) && fabs(normal.z) <= fabs(normal.y))
+        axis = Vec3(0,0,1);
+    e1 = normal.cross(axis);
+    e1 /= e1.norm();
+    e2 = normal.cross(e1);
+
+    min_proj = INFINITY;
+    max_diff = 0;
+    for(itype q=0; q<=d; q++)
+    {
+        diff[q] = ring[q] - center;
+        proj[q] = Vec2(diff[q].dot(e1),diff[q].dot(e2));
+        min_proj = std::min(min_proj,proj[q].norm());
+        max_diff = std::max(max_diff,diff[q].norm());
+    }
+    if(!(min_proj > 0))
+        return false;
+
+    // the star is star-shaped on the tangent plane if the angles around the normal are increasing,
+    // and it turns around v exactly once (less than once on the border)
+    angle[0] = atan2(proj[0].y,proj[0].x);
+    for(itype q=0; q<d; q++)
+    {
+        coord_type cross = proj[q].x*proj[q+1].y - proj[q].y*proj[q+1].x;
+        if(!(cross > 1e-12*proj[q].norm()*proj[q+1].norm()))
+            return false;
+        angle[q+1] = angle[q] + atan2(cross,proj[q].dot(proj[q+1]));
+    }
+    coord_type total = angle[d] - angle[0];
+    if((closed && fabs(total-2*PI) > 1e-6) || (!closed && total >= 2*PI-1e-6))
+        return false;
+
+    // the triangles opposite to each vertex, found by advancing the pointers with the vertices
+    opposite[0].assign(d+1,-1);
+    opposite[1].assign(d+1,-1);
+    if(closed)
+    {
+        // a second turn of the angles follows the first one
+        itype p = 0;
+        for(itype q=0; q<d; q++)
+        {
+            coord_type t = angle[q] + PI;
+            while(((p+1 <= d) ? angle[p+1] : angle[p+1-d]+total) <= t)
+                p++;
+            opposite[0][q] = p%d;
+        }
+    }
+    else
+    {
+        itype p = 0, m = 0;
+        for(itype q=0; q<=d; q++)
+        {
+            coord_type t = angle[q] + PI;
+            if(t <= angle[d])
+            {
+                while(p+1 < d && angle[p+1] <= t)
+                    p++;
+                opposite[0][q] = p;
+            }
+            t = angle[q] - PI;
+            if(t >= angle[0])
+            {
+                while(m+1 < d && angle[m+1] <= t)
+                    m++;
+                opposite[1][q] = m;
+            }
+        }
+    }
+    return true;
+}
+
+void Plane_Sweep::add_candidates(itype from, itype to)
+{
+    for(itype t=from-1; t<=to; t++)
+    {
+        if(closed)
+            candidates.push_back(((t%triangles_num)+triangles_num)%triangles_num);
+        else if(t >= 0 && t < triangles_num)
+            candidates.push_back(t);
+    }
+}
+
+coord_type Plane_Sweep::sin_from_plane(itype q, const Vec2 &n)
+{
+    if(closed)
+        q = ((q%triangles_num)+triangles_num)%triangles_num;
+    else if(q < 0 || q > triangles_num)
+        return 1;
+    return fabs(n.dot(proj[q])) / (n.norm()*proj[q].norm());
+}
+
+bool Plane_Sweep::find_plane_intersection(itype i, const Vec3 &w, const Vec3 &abc, Vec3 &w1)
+{
+    itype q = vv_pos[i];
+
+    // the triangles around w and around the opposite directions
+    candidates.clear();
+    add_candidates(q-1,q+1);
+    for(int s=0; s<2; s++)
+        if(opposite[s][q] != -1)
+            add_candidates(opposite[s][q]-1,opposite[s][q]+2);
+    std::sort(candidates.begin(),candidates.end(),[this](itype a, itype b){ return order[a] < order[b]; });
+    candidates.erase(std::unique(candidates.begin(),candidates.end()),candidates.end());
+
+    if((itype)candidates.size() < triangles_num)
+    {
+        // the plane function on the vertices outside the windows is, in absolute value, at least the one on the angle
+        // nearest to the line of the plane (the first vertices outside the windows, and the ends of a border star)
+        // times the minimum projection, less the component of abc along the normal
+        Vec2 n(abc.dot(e1),abc.dot(e2));
+        coord_type sin_min = std::min(sin_from_plane(q-2,n),sin_from_plane(q+2,n));
+        for(int s=0; s<2; s++)
+            if(opposite[s][q] != -1)
+                sin_min = std::min(sin_min,std::min(sin_from_plane(opposite[s][q]-2,n),sin_from_plane(opposite[s][q]+3,n)));
+        if(!closed)
+            sin_min = std::min(sin_min,std::min(sin_from_plane(0,n),sin_from_plane(triangles_num,n)));
+        coord_type bound = n.norm()*min_proj*(sin_min-1e-9) - fabs(abc.dot(normal))*max_diff;
+        if(!(bound > TOLER + 1e-12*abc.norm()*max_diff))
+            return false;
+    }
+
+    // the first intersection in the VT order
+    for(auto t : candidates)
+        if(Geometry_Curvature::edge_plane_intersection(ring[t],ring[t+1],center,w,abc,w1))
+            return true;
+    // simulate a vertical wall
+    w1 = center - normal;
+    return true;
+}
+
+//a mesh of num stars of the given degree, the closed ones alternating with the ones on the border (covering 5/6 of a turn),
+//with the vertices at random angles around the centers, on a wavy surface with some noise
+static void synthetic_stars(Spatial_Mesh &mesh, itype degree, itype num)
+{
+    unsigned seed = 12345;
+    auto random = [&seed]() { seed = seed*1103515245u + 12345u; return ((seed>>8)&0xffff)/65535.0; };
+    for(itype s=0; s<num; s++)
+    {
+        bool closed = (s%2 == 0);
+        itype ring_num = closed ? degree : degree+1;
+        coord_type span = closed ? 2*PI : 5*PI/3;
+        coord_type phase = 2*PI*random();
+        coord_type cx = 4*(s%64), cy = 4*(s/64);
+        itype c = mesh.get_vertices_num();
+        Vertex center(cx,cy,0);
+        mesh.add_vertex(center);
+        for(itype q=0; q<ring_num; q++)
+        {
+            coord_type a = phase + span*(q+0.5*random())/ring_num;
+            coord_type r = 1 + 0.3*sin(5*a);
+            Vertex p(cx+r*cos(a),cy+r*sin(a),0.3*r*sin(3*a)+0.002*(random()-0.5));
+            mesh.add_vertex(p);
+        }
+        for(itype q=0; q<degree; q++)
+            mesh.add_triangle(c,c+1+q,c+1+(q+1)%ring_num);
+    }
+}
+
+void Plane_Sweep::benchmark(itype max_degree, int repetitions)
+{
+    for(itype degree=SWEEP_MIN_DEGREE; degree<=max_degree; degree*=2)
+    {
+        Spatial_Mesh mesh;
+        itype num = std::max((itype)2,(itype)(1<<18)/degree);
+        synthetic_stars(mesh,degree,num);
+        if(!mesh.build())
+        {
+            cerr << "[ERROR] Failed to generate the IA data structure of the synthetic stars." << endl;
+            return;
+        }
+
+        // the mean of all the curves depends on every intersection
+        C_Curvature swept(MEAN_CCURVATURE,mesh,true), linear(MEAN_CCURVATURE,mesh,true);
+        linear.set_plane_sweep(false);
+        double t_swept = INFINITY, t_linear = INFINITY;
+        for(int r=0; r<repetitions; r++)
+        {
+            Timer time;
+            time.start();
+            swept.compute_values(mesh);
+            time.stop();
+            t_swept = std::min(t_swept,time.get_elapsed_time());
+            time.start();
+            linear.compute_values(mesh);
+            time.stop();
+            t_linear = std::min(t_linear,time.get_elapsed_time());
+        }
+
+        itype different = 0;
+        for(itype v=0; v<mesh.get_vertices_num(); v++)
+            if(swept.get_curvature(v) != linear.get_curvature(v) && !(std::isnan(swept.get_curvature(v)) && std::isnan(linear.get_curvature(v))))
+                different++;
+        cerr << "[TIME] degree " << degree << " (" << num << " stars) sweep: " << t_swept << " linear search: " << t_linear << endl;
+        cerr << "[STATS] degree " << degree << " speedup: " << t_linear/t_swept << " different values: " << different << endl;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLANE_SWEEP_H
+#define PLANE_SWEEP_H
+
+#include "ia/mesh.h"
+#include "geometry_curvature.h"
+
+//minimum number of incident triangles for sweeping a star, on the smaller stars the linear search is as fast
+#define SWEEP_MIN_DEGREE 64
+
+//finds the intersections between the star of a vertex v and the planes through v, its normal and each adjacent vertex w,
+//with a single counter-clockwise sweep of the star instead of a linear search for each plane.
+//when the star is star-shaped on the tangent plane of v, each plane crosses the edges opposite to v only around w and
+//around the direction opposite to w: the plane function is evaluated only on the triangles in these two windows, while
+//the ones outside are discarded by a lower bound of the plane function on their vertices.
+//the result is the one of Geometry_Curvature::find_plane_intersection, i.e., the first intersection in the VT order:
+//when the star is not star-shaped, or the lower bound does not exclude the triangles outside the windows, the caller
+//falls back to the linear search.
+class Plane_Sweep
+{
+public:
+    Plane_Sweep() {}
+
+    //sorts the star of v (vt and vv as returned by Mesh::VT and Mesh::VV) around the normal vnorm,
+    //returns false if the star is too small, or it cannot be swept
+    bool prepare(itype v, const Vec3 &vert, ivect &vt, const itype *vv, itype vv_num, bool is_border, const Vec3 &vnorm, Spatial_Mesh &mesh);
+    //sets w1 as Geometry_Curvature::find_plane_intersection for the i-th vertex w in vv and the plane coefficients abc,
+    //returns false if the result cannot be guaranteed to be the same
+    bool find_plane_intersection(itype i, const Vec3 &w, const Vec3 &abc, Vec3 &w1);
+
+    //compares the C curvatures computed with and without the sweep on synthetic stars of increasing degree (up to max_degree)
+    static void benchmark(itype max_degree, int repetitions);
+
+protected:
+    //the vertices following v in each triangle of VT (the edge opposite to v, counter-clockwise)
+    ivect first, second;
+    //the triangles of the star in counter-clockwise order (their positions in VT), the q-th triangle has vertices v, ring[q] and ring[q+1]
+    ivect order;
+    //the vertices around v (the first one is repeated at the end of a closed star), their difference from v,
+    //their projection on the tangent plane (local coordinates) and their angle around the normal (increasing)
+    vector<Vec3> ring;
+    vector<Vec3> diff;
+    vector<Vec2> proj;
+    dvect angle;
+    //for each vertex in ring, the triangles containing the direction opposite to it (-1 if none), on the two sides of a border star
+    ivect opposite[2];
+    //the position in ring of each vertex in vv
+    ivect vv_pos;
+    //the star
+    itype triangles_num;
+    bool closed;
+    //v, its normal and the tangent frame
+    Vec3 center, normal, e1, e2;
+    //the minimum length of the projections and the maximum length of the differences
+    coord_type min_proj, max_diff;
+    //the positions of the candidate triangles for a plane
+    ivect candidates;
+
+    //adds the triangles around the ring positions [from,to] to the candidates
+    void add_candidates(itype from, itype to);
+    //the sinus of the angle between the projection of the q-th ring vertex and the line of the plane (of normal n on the tangent plane)
+    coord_type sin_from_plane(itype q, const Vec2 &n);
+};
+
+#endif // PLANE_SWEEP_H
@@ -0,0 +1,145 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "triangle_scatter.h"
+#include "utilities/parallel.h"
+
+#include <stdint.h>
+
+#define MAX_COLORS 64
+
+void Triangle_Scatter::color_triangles(Spatial_Mesh &mesh)
+{
+    itype num_t = mesh.get_triangles_num();
+    vector<uint64_t> used(mesh.get_vertices_num(),0);
+    vector<char> color(num_t);
+
+    // the last counter is for the triangles without a color
+    color_offsets.assign(MAX_COLORS+2,0);
+    for(itype t=0; t<num_t; t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        uint64_t free = ~(used[tr.TV(0)] | used[tr.TV(1)] | used[tr.TV(2)]);
+        int c = MAX_COLORS;
+        if(free != 0)
+        {
+            c = __builtin_ctzll(free);
+            for(int i=0; i<3; i++)
+                used[tr.TV(i)] |= (1ULL << c);
+        }
+        color[t] = c;
+        color_offsets[c+1]++;
+    }
+    for(int c=0; c<=MAX_COLORS; c++)
+        color_offsets[c+1] += color_offsets[c];
+
+    // counting sort: each color keeps the triangles in increasing order
+    colored_triangles.resize(num_t);
+    ivect pos(color_offsets.begin(),color_offsets.end()-1);
+    for(itype t=0; t<num_t; t++)
+        colored_triangles[pos[color[t]]++] = t;
+
+    int num_colors = 0;
+    for(int c=0; c<MAX_COLORS; c++)
+        if(color_offsets[c+1] > color_offsets[c])
+            num_colors++;
+    cerr << "[STATS] triangle colors: " << num_colors << " uncolored triangles: "
+         << color_offsets[MAX_COLORS+1]-color_offsets[MAX_COLORS] << endl;
+}
+
+void Triangle_Scatter::compute(Spatial_Mesh &mesh, bool with_laplacian)
+{
+    itype num_v = mesh.get_vertices_num();
+    angle_sum.assign(num_v,0);
+    mixed_area.assign(num_v,0);
+    flags.assign(num_v,0);
+    if(with_laplacian)
+        laplacian.assign(num_v,Vec3());
+    else
+        laplacian.clear();
+
+    if(color_offsets.empty())
+        color_triangles(mesh);
+
+    // the triangles of a color are processed in blocks, whose angles are computed by the SIMD kernels
+    vector<trig_kernels::Triangle_Block> blocks(parallel::get_threads_num());
+    for(int c=0; c<=MAX_COLORS; c++)
+    {
+        itype first = color_offsets[c], num = color_offsets[c+1]-color_offsets[c];
+        itype num_blocks = (num+TRIG_BLOCK-1)/TRIG_BLOCK;
+        // the triangles without a color are processed serially
+        #pragma omp parallel for schedule(static) if(c<MAX_COLORS)
+        for(itype k=0; k<num_blocks; k++)
+        {
+            trig_kernels::Triangle_Block &b = blocks[parallel::get_thread_id()];
+            itype begin = first+k*TRIG_BLOCK, end = std::min(begin+TRIG_BLOCK,first+num);
+            b.num = 0;
+            for(itype i=begin; i<end; i++)
+            {
+                Triangle tr = mesh.get_triangle(colored_triangles[i]);
+                b.add(mesh.get_vertex(tr.TV(0)),mesh.get_vertex(tr.TV(1)),mesh.get_vertex(tr.TV(2)));
+            }
+            trig_kernels::triangle_corners(b);
+            for(itype i=begin; i<end; i++)
+                scatter(colored_triangles[i],b,i-begin,mesh,with_laplacian);
+        }
+    }
+}
+
+void Triangle_Scatter::scatter(itype t, trig_kernels::Triangle_Block &b, int j, Spatial_Mesh &mesh, bool with_laplacian)
+{
+    Triangle tr = mesh.get_triangle(t);
+    itype v[3] = { tr.TV(0), tr.TV(1), tr.TV(2) };
+
+    bool obtuse = (b.cos[0][j]<0.0)||(b.cos[1][j]<0.0)||(b.cos[2][j]<0.0);
+
+    for(int i=0; i<3; i++)
+    {
+        int i1 = (i+1)%3, i2 = (i+2)%3;
+        flags[v[i]] |= SCATTER_INCIDENT;
+        angle_sum[v[i]] += b.angle[i][j];
+
+        // mixed area (see Geometry_Curvature::voronoi_barycentric_area)
+        if(obtuse)
+            mixed_area[v[i]] += (b.cos[i][j]<0.0) ? 0.5*b.area[j] : 0.25*b.area[j];
+        else if(b.cos[i1][j]!=1.0 && b.cos[i2][j]!=1.0)
+            mixed_area[v[i]] += (b.cot[i2][j]*b.len[i2][j]*b.len[i2][j] + b.cot[i1][j]*b.len[i1][j]*b.len[i1][j]) / 8.0;
+
+        // the edge opposite to corner i is on the border if it has no adjacent triangle
+        if(tr.TT(i) == -1)
+        {
+            flags[v[i1]] |= SCATTER_BORDER;
+            flags[v[i2]] |= SCATTER_BORDER;
+        }
+
+        // cotangent weight of the edge opposite to corner i (skipped if the angle is degenerate, and on the border
+        // as, in the stars, only the edges shared by two triangles contribute)
+        if(with_laplacian && tr.TT(i) != -1 && b.cos[i][j]!=1.0 && b.cos[i][j]!=-1.0)
+        {
+            Vec3 diff = b.get_vertex(i1,j) - b.get_vertex(i2,j);
+            laplacian[v[i1]] += diff * b.cot[i][j];
+            laplacian[v[i2]] -= diff * b.cot[i][j];
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIANGLE_SCATTER_H
+#define TRIANGLE_SCATTER_H
+
+#include "ia/mesh.h"
+#include "geometry_curvature.h"
+#include "utilities/trig_kernels.h"
+
+///flags of the vertices in Triangle_Scatter
+#define SCATTER_INCIDENT 1 // the vertex has at least one incident triangle
+#define SCATTER_BORDER 2 // the vertex is on the mesh border
+
+//computes, visiting each triangle once, the per-vertex quantities used by the curvature estimators:
+//angle sums, mixed (Voronoi-barycentric) areas and cotangent-Laplacian vectors.
+//the contributions of a triangle are scattered to its three vertices; the triangles are
+//greedily colored so that triangles with the same color have no common vertex, and each color
+//is processed in parallel. thus the result does not depend on the number of threads.
+//NOTA: the border vertices are detected from the TT relation, no VT relation is extracted
+class Triangle_Scatter
+{
+public:
+    Triangle_Scatter() {}
+
+    //compute the per-vertex quantities (the cotangent Laplacian only if with_laplacian is true)
+    void compute(Spatial_Mesh &mesh, bool with_laplacian);
+
+    inline coord_type get_angle_sum(itype v) { return angle_sum[v]; }
+    inline coord_type get_mixed_area(itype v) { return mixed_area[v]; }
+    //sum over the edges v-w not on the border of (cot_a+cot_b)*(v-w), with a and b the angles opposite to the edge
+    inline Vec3& get_laplacian(itype v) { return laplacian[v]; }
+    inline bool is_incident(itype v) { return flags[v] & SCATTER_INCIDENT; }
+    inline bool is_border(itype v) { return flags[v] & SCATTER_BORDER; }
+
+protected:
+    dvect angle_sum;
+    dvect mixed_area;
+    vector<Vec3> laplacian;
+    vector<char> flags;
+
+    //triangles grouped by color: the triangles of color c are in [color_offsets[c],color_offsets[c+1])
+    //the last group contains the triangles that cannot be colored with 64 colors (processed serially)
+    ivect color_offsets;
+    ivect colored_triangles;
+
+    //greedy coloring of the triangles, using a 64-bit mask of the used colors for each vertex
+    void color_triangles(Spatial_Mesh &mesh);
+    //scatter the contributions of triangle t, the j-th triangle of block b, to its vertices
+    void scatter(itype t, trig_kernels::Triangle_Block &b, int j, Spatial_Mesh &mesh, bool with_laplacian);
+};
+
+#endif // TRIANGLE_SCATTER_H
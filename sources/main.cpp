@@ -31,8 +31,12 @@
 #include "curvature/mean_curvature.h"
 #include "curvature/concentrated_curvature.h"
 #include "curvature/c_curvature.h"
+#include "curvature/curvature_stars.h"
+#include "curvature/plane_sweep.h"
 
 #include "terrain_features/critical_points_extractor.h"
+#include "terrain_features/forman_gradient.h"
+#include "terrain_features/flow_router.h"
 #include "terrain_features/slope_extractor.h"
 
 #include "topological_main.cpp"
@@ -42,6 +46,10 @@
 #include "utilities/usage.h"
 #include "utilities/io.h"
 #include "utilities/timer.h"
+#include "utilities/parallel.h"
+#include "utilities/spatial_reordering.h"
+#include "utilities/trig_kernels.h"
+#include "utilities/field_writer.h"
 
 using namespace std;
 using namespace string_management;
@@ -52,6 +60,18 @@ using namespace string_management;
 
 void print_help();
 void print_paragraph(string stringa, int cols);
+void write_fields(Field_Writer &writer, Spatial_Mesh &mesh, const char *path);
+bool check_msc_reordering(Spatial_Mesh &mesh, const char *path);
+bool check_scatter(Spatial_Mesh &mesh);
+
+// the fields saved by the msc operation: the critical cells, the regions, and the edges on the descending (1)
+// and ascending (2) separatrices
+struct MSC_Fields
+{
+    vector<uint8_t> critical_v, critical_e, critical_t, separatrix_e;
+
+    MSC_Fields(Forman_Gradient &gradient, Spatial_Mesh &mesh, Field_Writer &writer);
+};
 
 int main(int argc, char *argv[])
 {
@@ -61,7 +81,37 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    if(argc < 2)
+    // the options are removed from the arguments list
+    // while the operation and the mesh name keep their order
+    vector<char*> args;
+    bool reorder = false, scatter = false, sos = false;
+    const char *output = NULL;
+    for(int i=0; i<argc; i++)
+    {
+        if(strcmp(argv[i],"--threads")==0 && i+1 < argc)
+            parallel::set_threads_num(atoi(argv[++i]));
+        else if(strcmp(argv[i],"--reorder")==0)
+            reorder = true;
+        else if(strcmp(argv[i],"--scatter")==0)
+            scatter = true;
+        else if(strcmp(argv[i],"--sos")==0)
+            sos = true;
+        else if(strcmp(argv[i],"-o")==0 && i+1 < argc)
+            output = argv[++i];
+        else
+            args.push_back(argv[i]);
+    }
+    argc = args.size();
+    argv = &args[0];
+
+    if(argc >= 2 && strcmp(argv[1],"sweepbench")==0)
+    {
+        // the stars are synthetic, no terrain is read
+        Plane_Sweep::benchmark((argc > 2) ? atoi(argv[2]) : 1024, 3);
+        return 0;
+    }
+
+    if(argc < 3)
     {
         cout << "[ERROR] too few arguments" << endl;
         return -1;
@@ -74,39 +124,87 @@ int main(int argc, char *argv[])
 
     Timer time;
     Spatial_Mesh mesh = Spatial_Mesh();
-    IO::read_mesh(mesh,argv[2]);
+    time.start();
+    if(!IO::read_mesh(mesh,argv[2]))
+        return -1;
+    time.stop();
+    time.print_elapsed_time("[TIME] loading the terrain: ");
+    cerr << "[NOTA] threads: " << parallel::get_threads_num() << endl;
     cerr << argv[2] << " vertices: " << mesh.get_vertices_num() << " triangles: " << mesh.get_triangles_num() << endl;
     cerr << "[MEMORY] peak for loading the terrain: " << to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
-    time.start();
-    bool generated = mesh.build();
-    if(!generated)
+    cerr << "[MEMORY] storage of the mesh arrays: " << to_string(mesh.get_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+    if(!mesh.is_built() && !reorder)
     {
-        cerr<<"[ERROR] Failed to generate the IA data structure."<<endl;
-        return -1;
+        // a connectivity previously saved for the same mesh avoids the IA generation
+        time.start();
+        bool loaded = IO::read_mesh_connectivity(mesh,string_management::get_path_without_file_extension(argv[2]));
+        time.stop();
+        time.print_elapsed_time(loaded ? "[TIME] loading the IA connectivity: " : "[TIME] looking for a saved IA connectivity: ");
     }
-    time.stop();
-    time.print_elapsed_time("[TIME] IA generation: ");
-    cerr << "[MEMORY] peak for generating the IA: " << to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+    if(reorder)
+    {
+        // the input order is needed only by the procedures writing the mesh connectivity or the fields,
+        // and by the critical points, the Morse-Smale complex and the flow, that break the ties between equal elevations on the input index
+        time.start();
+        Spatial_Reordering::hilbert_reorder(mesh,strcmp(argv[1],"save")==0 || output != NULL || strcmp(argv[1],"crit")==0 ||
+                                            strcmp(argv[1],"msc")==0 || strcmp(argv[1],"flow")==0);
+        time.stop();
+        time.print_elapsed_time("[TIME] Hilbert reordering: ");
+    }
+    if(mesh.is_built())
+        cerr << "[NOTA] IA data structure loaded (generation skipped)" << endl;
+    else
+    {
+        time.start();
+        bool generated = mesh.build();
+        if(!generated)
+        {
+            cerr<<"[ERROR] Failed to generate the IA data structure."<<endl;
+            return -1;
+        }
+        time.stop();
+        time.print_elapsed_time("[TIME] IA generation: ");
+        cerr << "[MEMORY] peak for generating the IA: " << to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+    }
+    cerr << "[MEMORY] storage of the IA data structure: " << to_string(mesh.get_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
 
     if(strcmp(argv[1],"concurv")==0)
     {
         ConcentratedCurvature ccurv = ConcentratedCurvature(true,mesh);
         time.start();
-        ccurv.compute_values(mesh);
+        if(scatter)
+            ccurv.compute_values_scatter(mesh);
+        else
+            ccurv.compute_values(mesh);
         time.stop();
         time.print_elapsed_time("[TIME] Computing Concentrated Curvatures: ");
         cerr << "[MEMORY] peak for extracting the Concentrated Curvatures: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_vertex_field("concentrated_curvature",ccurv.get_curvatures());
+            write_fields(writer,mesh,output);
+        }
     }
     else if(strcmp(argv[1],"meancurv")==0)
     {
         MeanCurvature mcurv = MeanCurvature(true,mesh);
         time.start();
-        mcurv.compute_values(mesh);
+        if(scatter)
+            mcurv.compute_values_scatter(mesh);
+        else
+            mcurv.compute_values(mesh);
         time.stop();
         time.print_elapsed_time("[TIME] Computing Mean Curvatures: ");
         cerr << "[MEMORY] peak for extracting the Mean Curvatures: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_vertex_field("mean_curvature",mcurv.get_curvatures());
+            write_fields(writer,mesh,output);
+        }
     }
     else if(strcmp(argv[1],"gccurv")==0 || strcmp(argv[1],"mccurv")==0)
     {
@@ -118,7 +216,56 @@ int main(int argc, char *argv[])
         time.print_elapsed_time("[TIME] Computing CCurvatures: ");
         cerr << "[MEMORY] peak for extracting the C Curvatures: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_vertex_field((type==GAUSS_CCURVATURE) ? "gauss_ccurvature" : "mean_ccurvature",ccurv.get_curvatures());
+            write_fields(writer,mesh,output);
+        }
     }
+    else if(strcmp(argv[1],"allcurv")==0)
+    {
+        ConcentratedCurvature ccurv = ConcentratedCurvature(true,mesh);
+        MeanCurvature mcurv = MeanCurvature(true,mesh);
+        C_Curvature gccurv = C_Curvature(GAUSS_CCURVATURE,mesh);
+        C_Curvature mccurv = C_Curvature(MEAN_CCURVATURE,mesh,true);
+        Timer total;
+        total.start();
+        time.start();
+        Curvature_Stars stars;
+        stars.compute(mesh);
+        time.stop();
+        time.print_elapsed_time("[TIME] Visiting the stars (angles, areas, normals, VT and VV): ");
+        time.start();
+        ccurv.compute_values_from_stars(stars);
+        time.stop();
+        time.print_elapsed_time("[TIME] Computing Concentrated Curvatures: ");
+        time.start();
+        mcurv.compute_values_from_stars(stars);
+        time.stop();
+        time.print_elapsed_time("[TIME] Computing Mean Curvatures: ");
+        time.start();
+        C_Curvature::compute_values_from_stars(stars,mesh,gccurv,mccurv);
+        time.stop();
+        time.print_elapsed_time("[TIME] Computing Gauss and Mean CCurvatures: ");
+        total.stop();
+        total.print_elapsed_time("[TIME] Computing all the curvatures: ");
+        cerr << "[MEMORY] storage of the shared stars: " << to_string(stars.get_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+        cerr << "[MEMORY] storage of the normals: " << to_string(mesh.get_normal_field().get_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+        cerr << "[MEMORY] peak for extracting all the curvatures: " <<
+                to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_vertex_field("concentrated_curvature",ccurv.get_curvatures());
+            writer.add_vertex_field("mean_curvature",mcurv.get_curvatures());
+            writer.add_vertex_field("gauss_ccurvature",gccurv.get_curvatures());
+            writer.add_vertex_field("mean_ccurvature",mccurv.get_curvatures());
+            write_fields(writer,mesh,output);
+        }
+    }
+    else if(strcmp(argv[1],"trigbench")==0)
+        trig_kernels::benchmark(mesh,5);
     else if(strcmp(argv[1],"vtall")==0)
         VT_ALL(mesh);
     else if(strcmp(argv[1],"all")==0)
@@ -141,6 +288,12 @@ int main(int argc, char *argv[])
         time.print_elapsed_time("[TIME] Computing Edge Slopes: ");
         cerr << "[MEMORY] peak for extracting the edge slopes: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_edge_field("slope",se.get_edges_slopes());
+            write_fields(writer,mesh,output);
+        }
     }
     else if(strcmp(argv[1],"tslope")==0)
     {
@@ -151,29 +304,248 @@ int main(int argc, char *argv[])
         time.print_elapsed_time("[TIME] Computing Triangle Slopes: ");
         cerr << "[MEMORY] peak for extracting the triangles slopes: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_triangle_field("slope",se.get_triangles_slopes());
+            write_fields(writer,mesh,output);
+        }
     }
     else if(strcmp(argv[1],"crit")==0)
     {
         Critical_Points_Extractor cpe;
         time.start();
-        cpe.compute_critical_points(mesh);
+        cpe.compute_critical_points(mesh,sos);
         time.stop();
         time.print_elapsed_time("[TIME] Computing Critical Points: ");
         cerr << "[MEMORY] peak for extracting the critical points: " <<
                 to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
         cpe.print_stats();
+        if(output != NULL)
+        {
+            // the type of each vertex, as the values of Point_Type
+            vector<Point_Type> &points = cpe.get_critical_points();
+            vector<uint8_t> types(points.size());
+            for(size_t v=0; v<points.size(); v++)
+                types[v] = (uint8_t)points[v];
+            Field_Writer writer;
+            writer.add_vertex_field("critical_type",types);
+            write_fields(writer,mesh,output);
+        }
+    }
+    else if(strcmp(argv[1],"critbench")==0)
+    {
+        Critical_Points_Extractor cpe;
+        cpe.benchmark(mesh,5);
+    }
+    else if(strcmp(argv[1],"msc")==0)
+    {
+        Forman_Gradient gradient;
+        time.start();
+        gradient.compute_gradient(mesh);
+        time.stop();
+        time.print_elapsed_time("[TIME] Computing the Forman Gradient: ");
+        time.start();
+        gradient.compute_morse_smale(mesh);
+        time.stop();
+        time.print_elapsed_time("[TIME] Extracting the Morse-Smale complex: ");
+        cerr << "[MEMORY] peak for extracting the Morse-Smale complex: " <<
+                to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        cerr << "[MEMORY] storage of the gradient: " << to_string(gradient.get_gradient_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+        cerr << "[MEMORY] storage of the separatrices and the regions: " <<
+                to_string(gradient.get_complex_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+        gradient.print_stats(mesh);
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            MSC_Fields fields(gradient,mesh,writer);
+            write_fields(writer,mesh,output);
+        }
+    }
+    else if(strcmp(argv[1],"scattercheck")==0)
+    {
+        if(!check_scatter(mesh))
+            return -1;
+    }
+    else if(strcmp(argv[1],"msccheck")==0)
+    {
+        if(!check_msc_reordering(mesh,argv[2]))
+            return -1;
+    }
+    else if(strcmp(argv[1],"flow")==0)
+    {
+        Flow_Router router;
+        time.start();
+        router.compute_receivers(mesh);
+        time.stop();
+        time.print_elapsed_time("[TIME] Computing the steepest descent receivers: ");
+        time.start();
+        router.compute_accumulation();
+        time.stop();
+        time.print_elapsed_time("[TIME] Accumulating the flow: ");
+        cerr << "[MEMORY] peak for computing the drainage areas: " <<
+                to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " MBs" << std::endl;
+        cerr << "[MEMORY] storage of the receivers and the drainage areas: " <<
+                to_string(router.get_storage_size()/(1024.0*1024.0)) << " MBs" << std::endl;
+        router.print_stats();
+        if(output != NULL)
+        {
+            Field_Writer writer;
+            writer.add_vertex_field("drainage_area",router.get_drainage_areas());
+            write_fields(writer,mesh,output);
+        }
     }
     else if(strcmp(argv[1],"save")==0)
     {
-        cout<<"[NOTA] Saving mesh connectivity."<<endl;
+        cout<<"[NOTA] Saving mesh connectivity (.ia_conn and .ia_conn_bin)."<<endl;
         IO::write_mesh_connectivity(mesh,string_management::get_path_without_file_extension(argv[2]));
     }
+    else if(strcmp(argv[1],"convert")==0)
+    {
+        cout<<"[NOTA] Saving the mesh in binary format."<<endl;
+        time.start();
+        IO::write_mesh_binary(mesh,string_management::get_path_without_file_extension(argv[2]));
+        time.stop();
+        time.print_elapsed_time("[TIME] Writing the binary mesh: ");
+    }
     else
         cout<<"error reading arguments"<<endl;
 
     return 0;
 }
 
+void write_fields(Field_Writer &writer, Spatial_Mesh &mesh, const char *path)
+{
+    Timer time;
+    time.start();
+    if(!writer.write_ply(mesh,path))
+        return;
+    time.stop();
+    time.print_elapsed_time("[TIME] Writing the fields: ");
+}
+
+MSC_Fields::MSC_Fields(Forman_Gradient &gradient, Spatial_Mesh &mesh, Field_Writer &writer)
+    : critical_v(mesh.get_vertices_num(),0), critical_e(mesh.get_edges_num(),0), critical_t(mesh.get_triangles_num(),0),
+      separatrix_e(mesh.get_edges_num(),0)
+{
+    for(itype v : gradient.get_critical_vertices())
+        critical_v[v] = 1;
+    for(itype e : gradient.get_critical_edges())
+        critical_e[e] = 1;
+    for(itype t : gradient.get_critical_triangles())
+        critical_t[t] = 1;
+    for(itype v : gradient.get_descending_separatrices().cells)
+    {
+        if(gradient.get_vertex_pair(v) != -1)
+            separatrix_e[gradient.get_vertex_pair(v)] = 1;
+    }
+    for(itype t : gradient.get_ascending_separatrices().cells)
+    {
+        if(gradient.get_triangle_pair(t) != -1)
+            separatrix_e[gradient.get_triangle_pair(t)] = 2;
+    }
+    writer.add_vertex_field("critical",critical_v);
+    writer.add_vertex_field("region",gradient.get_vertex_regions());
+    writer.add_triangle_field("critical",critical_t);
+    writer.add_triangle_field("region",gradient.get_triangle_regions());
+    writer.add_edge_field("critical",critical_e);
+    writer.add_edge_field("separatrix",separatrix_e);
+}
+
+// the number of values of a and b whose difference, relative to the largest of |a|, |b| and 1 (so that the values
+// close to zero are compared in absolute terms), is above SCATTER_TOLERANCE, and the maximum one
+#define SCATTER_TOLERANCE 4e-10
+static itype count_differences(const dvect &a, const dvect &b, coord_type &max_diff)
+{
+    itype different = 0;
+    max_diff = 0;
+    for(size_t i=0; i<a.size(); i++)
+    {
+        coord_type scale = std::max(fabs(a[i]),fabs(b[i]));
+        coord_type diff = fabs(a[i]-b[i])/std::max(scale,1.0);
+        max_diff = std::max(max_diff,diff);
+        if(diff > SCATTER_TOLERANCE)
+            different++;
+    }
+    return different;
+}
+
+// compares the concentrated and mean curvatures computed on the stars of the vertices, by the scatter of the triangles
+// and from the shared stars of allcurv, which must be the same up to rounding
+bool check_scatter(Spatial_Mesh &mesh)
+{
+    ConcentratedCurvature ccurv(true,mesh), ccurv_scatter(true,mesh), ccurv_stars(true,mesh);
+    MeanCurvature mcurv(true,mesh), mcurv_scatter(true,mesh), mcurv_stars(true,mesh);
+    ccurv.compute_values(mesh);
+    ccurv_scatter.compute_values_scatter(mesh);
+    mcurv.compute_values(mesh);
+    mcurv_scatter.compute_values_scatter(mesh);
+    Curvature_Stars stars;
+    stars.compute(mesh);
+    ccurv_stars.compute_values_from_stars(stars);
+    mcurv_stars.compute_values_from_stars(stars);
+
+    struct { const char *name; const dvect &a, &b; } pairs[] = {
+        {"concurv, scatter",ccurv.get_curvatures(),ccurv_scatter.get_curvatures()},
+        {"concurv, allcurv",ccurv.get_curvatures(),ccurv_stars.get_curvatures()},
+        {"meancurv, scatter",mcurv.get_curvatures(),mcurv_scatter.get_curvatures()},
+        {"meancurv, allcurv",mcurv.get_curvatures(),mcurv_stars.get_curvatures()}
+    };
+    bool same = true;
+    for(auto &p : pairs)
+    {
+        coord_type max_diff;
+        itype different = count_differences(p.a,p.b,max_diff);
+        cerr << "[STATS] " << p.name << " versus the stars: max relative difference " << max_diff
+             << " -- values above " << SCATTER_TOLERANCE << ": " << different << endl;
+        same = same && different == 0;
+    }
+    return same;
+}
+
+// writes the PLY output of msc on mesh, and on a copy of the mesh read from path and reordered along the Hilbert curve,
+// and compares the two files
+bool check_msc_reordering(Spatial_Mesh &mesh, const char *path)
+{
+    Spatial_Mesh reordered;
+    if(!IO::read_mesh(reordered,path))
+        return false;
+    Spatial_Reordering::hilbert_reorder(reordered,true);
+    if(!reordered.build())
+    {
+        cerr<<"[ERROR] Failed to generate the IA data structure."<<endl;
+        return false;
+    }
+
+    // the content of the PLY output of each mesh
+    string contents[2];
+    Spatial_Mesh *meshes[2] = {&mesh, &reordered};
+    for(int i=0; i<2; i++)
+    {
+        Forman_Gradient gradient;
+        gradient.compute_gradient(*meshes[i]);
+        gradient.compute_morse_smale(*meshes[i]);
+        Field_Writer writer;
+        MSC_Fields fields(gradient,*meshes[i],writer);
+        FILE *file = tmpfile();
+        if(file == NULL || !writer.write_ply(*meshes[i],file))
+        {
+            cerr << "[ERROR] cannot write the PLY output in a temporary file." << endl;
+            return false;
+        }
+        contents[i].resize(ftell(file));
+        rewind(file);
+        if(fread(&contents[i][0],1,contents[i].size(),file) != contents[i].size())
+            contents[i].clear();
+        fclose(file);
+    }
+
+    bool same = !contents[0].empty() && contents[0] == contents[1];
+    cerr << "[STATS] PLY output of msc with and without the Hilbert reordering: " << contents[0].size() << " and "
+         << contents[1].size() << " bytes, " << (same ? "identical" : "DIFFERENT") << endl;
+    return same;
+}
+
 void print_help(){
 
     //annoying stuff to get the dimension of the output shell (!!! not sure it works on Mac,
@@ -196,24 +568,43 @@ void print_help(){
     printf("\tLibTri library - Adjacency-based data structure for representing and analyzing triangle meshes.\n\n" RESET);
 
     printf(BOLD "  USAGE: \n\n" RESET);
-    printf(BOLD "    .\\libtri [operation] [mesh_name]\n\n" RESET);
-    print_paragraph("NOTA: the arguments order is fixed.", cols);
+    printf(BOLD "    .\\libtri [operation] [mesh_name] [options]\n\n" RESET);
+    print_paragraph("NOTA: the order of the operation and mesh_name arguments is fixed.", cols);
 
     printf(BOLD "    [operation]\n\n" RESET);
-    print_paragraph("the operation argument can be vtall, all, meancurv, concurv, gcurv, mccurv, eslope, tslope, crit.",cols);
+    print_paragraph("the operation argument can be vtall, all, meancurv, concurv, gcurv, mccurv, allcurv, trigbench, sweepbench, scattercheck, eslope, tslope, crit, critbench, msc, msccheck, flow, save, convert.",cols);
     printf(BOLD "        vtall\n" RESET); print_paragraph(" extracts all the VT relations of the input mesh (prints timings - no output).",cols);
     printf(BOLD "        all\n" RESET); print_paragraph(" extracts all the topological relations of the input mesh (prints timings - no output).",cols);
     printf(BOLD "        meancurv\n" RESET); print_paragraph(" computes the Mean Curvature for all the mesh vertices.",cols);
     printf(BOLD "        concurv\n" RESET); print_paragraph(" computes the Concentrated Curvature for all the mesh vertices.",cols);
     printf(BOLD "        mccurv\n" RESET); print_paragraph(" computes the Mean CCurvature for all the mesh vertices.",cols);
     printf(BOLD "        gccurv\n" RESET); print_paragraph(" computes the Gauss CCurvature for all the mesh vertices.",cols);
+    printf(BOLD "        allcurv\n" RESET); print_paragraph(" computes the Concentrated, Mean, Gauss CCurvature and Mean CCurvature for all the mesh vertices, visiting the star of each vertex once.",cols);
+    printf(BOLD "        trigbench\n" RESET); print_paragraph(" measures the throughput of the SIMD kernels computing the angles, cotangents, areas and normals of the triangles (the instruction set is selected at compile time) versus the scalar path, and their maximum differences.",cols);
+    printf(BOLD "        sweepbench [max degree]\n" RESET); print_paragraph(" compares the C curvatures computed by sweeping the stars and by the linear search of the plane intersections, on synthetic stars with up to max degree (default 1024) incident triangles, and counts the different values (no terrain is read).",cols);
     printf(BOLD "        quad\n" RESET); print_paragraph(" extracts the dual quad mesh from the input mesh and saves it in off format.",cols);
     printf(BOLD "        eslope\n" RESET); print_paragraph(" computes the the slope values for each edge of the mesh.",cols);
     printf(BOLD "        tslope\n" RESET); print_paragraph(" computes the the slope values for each triangle of the mesh.",cols);
-    printf(BOLD "        crit\n" RESET); print_paragraph(" computes the critical points of the mesh.",cols);
+    printf(BOLD "        crit\n" RESET); print_paragraph(" computes the critical points of the mesh (each plateau, i.e., connected set of vertices with the same elevation, is classified as a single vertex).",cols);
+    printf(BOLD "        critbench\n" RESET); print_paragraph(" compares the classification of the critical points counting the sign changes around the links with the one merging the link components, and counts the different labels.",cols);
+    printf(BOLD "        msc\n" RESET); print_paragraph(" computes the Forman gradient of the mesh (ordering the vertices as with the simulation of simplicity) and extracts the Morse-Smale complex: the critical cells, the separatrices and the regions of the minima (on the vertices) and of the maxima (on the triangles).",cols);
+    printf(BOLD "        scattercheck\n" RESET); print_paragraph(" checks that the concurv and meancurv values computed on the stars of the vertices, with --scatter and by allcurv are the same up to rounding (difference up to 4e-10, relative to the values or absolute for values below 1; exits with an error otherwise).",cols);
+    printf(BOLD "        msccheck\n" RESET); print_paragraph(" checks that the output of msc does not depend on the order of the mesh, comparing the PLY files computed on the input mesh and on the mesh reordered along the Hilbert curve (exits with an error if they differ).",cols);
+    printf(BOLD "        flow\n" RESET); print_paragraph(" routes the flow of each vertex to its steepest descent neighbor and accumulates the drainage area of each vertex, in parallel one level of the flow paths at a time.",cols);
+
+    printf(BOLD "        save\n" RESET); print_paragraph(" saves the IA connectivity (VTstar and TT relations) in ASCII and binary format. When present, and computed on the same mesh, it is loaded in place of generating the IA.",cols);
+    printf(BOLD "        convert\n" RESET); print_paragraph(" saves the mesh, with the IA data structure, in the binary format (.ia_mesh) that is memory-mapped when loaded.",cols);
 
     printf(BOLD "    [mesh_name]\n\n" RESET);
-    print_paragraph("the mesh_name argument represents the triangular mesh (in .tri format).",cols);
+    print_paragraph("the mesh_name argument represents the triangular mesh (in .tri, .off or .ia_mesh format).",cols);
+
+    printf(BOLD "    [options]\n\n" RESET);
+    printf(BOLD "        --threads [num]\n" RESET); print_paragraph(" sets the number of threads used by the parallel procedures (by default all the available cores).",cols);
+
+    printf(BOLD "        --scatter\n" RESET); print_paragraph(" computes the concurv and meancurv values visiting each triangle once and scattering its contributions to its vertices, instead of visiting the star of each vertex (the values are the same, up to rounding, see scattercheck).",cols);
+    printf(BOLD "        --reorder\n" RESET); print_paragraph(" sorts vertices and triangles along the Hilbert curve of their (x,y) position before generating the IA (the connectivity and the fields are saved in the input order).",cols);
+    printf(BOLD "        --sos\n" RESET); print_paragraph(" the crit operation breaks the ties between equal elevations by the input index of the vertices (simulation of simplicity), classifying each vertex by its link instead of resolving the plateaus.",cols);
+    printf(BOLD "        -o [file.ply]\n" RESET); print_paragraph(" saves the mesh with the computed values (the curvatures and the critical points on the vertices, the slopes on the triangles or on the edges, the critical cells, the separatrices and the regions of the Morse-Smale complex, the drainage areas) in a binary PLY file.",cols);
 
     printf(BOLD "  EXAMPLE: \n\n" RESET);
     printf("          .\\libtri vtall mesh.tri\n\n");
@@ -22,93 +22,174 @@
  */
 
 #include "critical_points_extractor.h"
+#include "utilities/timer.h"
+#include "utilities/parallel.h"
 
-void Critical_Points_Extractor::compute_critical_points(Spatial_Mesh &mesh)
+#include <algorithm>
+
+void Critical_Points_Extractor::compute_critical_points(Spatial_Mesh &mesh, bool simulation_of_simplicity)
 {
     this->critical_points.assign(mesh.get_vertices_num(),Point_Type::REGULAR); //the default is a regular vertex
+    if(simulation_of_simplicity)
+    {
+        this->plateaus = Plateaus();
+        this->extract_critical_points_sos(mesh);
+        return;
+    }
     this->extract_critical_points(mesh);
+    this->plateaus.compute(mesh);
+    this->extract_critical_plateaus(mesh);
 }
 
-void Critical_Points_Extractor::extract_critical_points(Spatial_Mesh &mesh, flat_areas &fa)
+void Critical_Points_Extractor::extract_critical_points(Spatial_Mesh &mesh)
 {
+    // each label depends only on its vertex, thus the result does not depend on the schedule
+    #pragma omp parallel for schedule(dynamic,4096)
     for(itype i=0; i<mesh.get_vertices_num(); i++)
     {
-        Vertex &v = mesh.get_vertex(i);
-        ivect vv = mesh.VV(i);
-        bool isb=false;
-        ivect vt = mesh.VT(i,isb);
+        bool flat;
+        this->critical_points[i] = classify_vertex(i,mesh,flat);
+    }
+}
 
-        bool into_flat_area = false;
-        map<itype,itype> upper, lower;
+Point_Type Critical_Points_Extractor::classify_vertex(itype v, Spatial_Mesh &mesh, bool &flat)
+{
+    coord_type z = mesh.get_vertex(v).get_c(2);
+    return classify_link(v,mesh,[&mesh,z](itype w)
+    {
+        coord_type zw = mesh.get_vertex(w).get_c(2);
+        return (zw > z) - (zw < z);
+    },flat);
+}
 
-        for(auto vid : vv)
+template<class Side> Point_Type Critical_Points_Extractor::classify_link(itype v, Spatial_Mesh &mesh, Side side, bool &flat)
+{
+    // the link of v is a cycle (or a path on the border) formed by the edges opposite to v in its triangles:
+    // the upper (lower) components are the maximal runs of upper (lower) vertices, thus their number is
+    // half the number of link edges with a sign change, plus the upper (lower) extremes of a path
+    itype changes = 0;
+    int upper_ends = 0, lower_ends = 0;
+    bool upper = false, lower = false;
+    flat = false;
+
+    mesh.for_each_VT(v,[&](itype t_id)
+    {
+        if(flat)
+            return;
+        Triangle t = mesh.get_triangle(t_id);
+        int k = t.vertex_index(v);
+        int s1 = side(t.TV((k+1)%3));
+        int s2 = side(t.TV((k+2)%3));
+        if(s1 == 0 || s2 == 0)
         {
-            Vertex &v2 = mesh.get_vertex(vid);
-
-            if(v.get_c(2) == v2.get_c(2))
-            {
-                flat_areas::iterator ret = fa.find(v.get_c(2));
-                if(ret == fa.end())
-                {
-                    iset triangles;
-                    triangles.insert(vt.begin(),vt.end());
-                    fa.insert(make_pair(v.get_c(2),triangles));
-                }
-                else
-                {
-                    ret->second.insert(vt.begin(),vt.end());
-                }
-                into_flat_area = true;
-                break;
-            }
-            else if(v.get_c(2) > v2.get_c(2))
-            {
-                lower.insert(make_pair(vid,vid)); //initially the component is formed only by the vertex itself
-            }
-            else
-            {
-                upper.insert(make_pair(vid,vid)); //initially the component is formed only by the vertex itself
-            }
+            flat = true;
+            return;
         }
-
-        if(!into_flat_area)
+        bool up1 = s1 > 0, up2 = s2 > 0;
+        upper |= up1 || up2;
+        lower |= !up1 || !up2;
+        if(up1 != up2)
+            changes++;
+        // the edge from v to an extreme of the path is on the border
+        if(t.TT((k+2)%3) == -1)
         {
-            if(upper.empty()) //the vertex is a maximum
-                this->critical_points[i] = Point_Type::MAXIMUM;
-            else if(lower.empty()) //the vertex is a minimum
-                this->critical_points[i] = Point_Type::MINIMUM;
-            else //we have to check the connected components of the edges in the link
-            {
-                map<itype,iset> adj_upper;
-                map<itype,iset> adj_lower;
+            if(up1) upper_ends++;
+            else lower_ends++;
+        }
+        if(t.TT((k+1)%3) == -1)
+        {
+            if(up2) upper_ends++;
+            else lower_ends++;
+        }
+    });
+
+    if(flat)
+        return Point_Type::REGULAR; // as in the classification by components, the flat areas are not classified
+    if(!upper) //the vertex is a maximum (as an isolated vertex)
+        return Point_Type::MAXIMUM;
+    if(!lower) //the vertex is a minimum
+        return Point_Type::MINIMUM;
+
+    itype uc_num = (changes + upper_ends) / 2;
+    itype lc_num = (changes + lower_ends) / 2;
+    if(uc_num == 2 && lc_num == 2) // simple saddle
+        return Point_Type::SADDLE;
+    else if(uc_num > 2 && lc_num > 2) // multiple saddle
+        return Point_Type::MULTIPLE_SADDLE;
+    return Point_Type::REGULAR;
+}
 
-                // get the adjacent vertices that have greater or lower field values w.r.t. v
-                init_adjacent_vertices(i,v,vt,mesh,adj_upper,adj_lower);
+void Critical_Points_Extractor::compute_ranks(Spatial_Mesh &mesh, ivect &ranks)
+{
+    itype num_v = mesh.get_vertices_num();
+    ivect order(num_v);
+    for(itype v=0; v<num_v; v++)
+        order[v] = v;
+    std::sort(order.begin(),order.end(),[&mesh](itype a, itype b) { return precedes(mesh,a,b); });
+    ranks.resize(num_v);
+    #pragma omp parallel for schedule(static)
+    for(itype i=0; i<num_v; i++)
+        ranks[order[i]] = i;
+}
 
-                // merge upper components
-                utype uc_num = get_components_num(adj_upper,upper);
-                // merge lower components
-                utype lc_num = get_components_num(adj_lower,lower);
+void Critical_Points_Extractor::extract_critical_points_sos(Spatial_Mesh &mesh)
+{
+    ivect ranks;
+    compute_ranks(mesh,ranks);
 
-                if(uc_num == 2 && lc_num == 2) // simple saddle
-                    this->critical_points[i] = Point_Type::SADDLE;
-                else if(uc_num > 2 && lc_num > 2) // multiple saddle
-                    this->critical_points[i] = Point_Type::MULTIPLE_SADDLE;
-                // else the point is already flagged as regular point
-            }
-        }
+    // each label depends only on its vertex, thus the result does not depend on the schedule
+    #pragma omp parallel for schedule(dynamic,4096)
+    for(itype i=0; i<mesh.get_vertices_num(); i++)
+    {
+        bool flat;
+        itype rank = ranks[i];
+        this->critical_points[i] = classify_link(i,mesh,[&ranks,rank](itype w) { return (ranks[w] > rank) ? 1 : -1; },flat);
     }
 }
 
-void Critical_Points_Extractor::extract_critical_points(Spatial_Mesh &mesh)
+void Critical_Points_Extractor::benchmark(Spatial_Mesh &mesh, int repetitions)
+{
+    Timer time;
+    itype num_v = mesh.get_vertices_num();
+    double by_changes = INFINITY, by_components = INFINITY;
+    vector<Point_Type> reference;
+    for(int r=0; r<repetitions; r++)
+    {
+        this->critical_points.assign(num_v,Point_Type::REGULAR);
+        time.start();
+        this->extract_critical_points_by_components(mesh);
+        time.stop();
+        by_components = std::min(by_components,time.get_elapsed_time());
+        reference.swap(this->critical_points);
+
+        this->critical_points.assign(num_v,Point_Type::REGULAR);
+        time.start();
+        this->extract_critical_points(mesh);
+        time.stop();
+        by_changes = std::min(by_changes,time.get_elapsed_time());
+    }
+
+    itype different = 0;
+    for(itype v=0; v<num_v; v++)
+    {
+        if(reference[v] != this->critical_points[v])
+            different++;
+    }
+    cerr << "[TIME] link sign changes: " << by_changes << endl;
+    cerr << "[TIME] link components (maps): " << by_components << endl;
+    cerr << "[STATS] speedup: " << by_components/by_changes << endl;
+    cerr << "[STATS] different labels: " << different << endl;
+}
+
+void Critical_Points_Extractor::extract_critical_points_by_components(Spatial_Mesh &mesh)
 {
 
     for(itype i=0; i<mesh.get_vertices_num(); i++)
     {
         Vertex &v = mesh.get_vertex(i);
-        ivect vv = mesh.VV(i);
+        mesh.VV(i,vv);
         bool isb=false;
-        ivect vt = mesh.VT(i,isb);
+        mesh.VT(i,vt,isb);
 
         bool into_flat_area = false;
         map<itype,itype> upper, lower;
@@ -161,77 +242,137 @@ void Critical_Points_Extractor::extract_critical_points(Spatial_Mesh &mesh)
     }
 }
 
-void Critical_Points_Extractor::extract_critical_points_from_flat_areas(flat_areas &fa, Spatial_Mesh &mesh)
+void Critical_Points_Extractor::extract_critical_plateaus(Spatial_Mesh &mesh)
 {
-    map<itype,itype> upper, lower;
-    map<itype,iset> adj_upper;
-    map<itype,iset> adj_lower;
-
-    for(flat_areas::iterator it=fa.begin(); it!=fa.end(); ++it)
+    // each label depends only on its plateau, thus the result does not depend on the schedule
+    #pragma omp parallel
     {
-        itype key_vertex = -1;
-        double field = it->first;
-        iset &vt = it->second;
-
-        for(auto tid : vt)
+        ivect boundary, parent, slots;
+        #pragma omp for schedule(dynamic,64)
+        for(itype p=0; p<plateaus.get_plateaus_num(); p++)
         {
-            Triangle &t = mesh.get_triangle(tid);
-            ivect link_v;
-            for(int i=0; i<t.vertices_num(); i++)
+            // the label goes on the vertex with the lowest input index, thus it does not move if the mesh is reordered
+            const itype *vertices = plateaus.get_vertices(p);
+            itype label_v = vertices[0];
+            for(itype i=1; i<plateaus.get_vertices_num(p); i++)
             {
-                Vertex &v = mesh.get_vertex(t.TV(i));
-                if(v.get_c(2) != field)
-                {
-                    if(v.get_c(2) < field)
-                        lower[t.TV(i)] = t.TV(i);
-                    else
-                        upper[t.TV(i)] = t.TV(i);
-                    link_v.push_back(t.TV(i));
-                }
-                else if(key_vertex == -1)//same field and still unitialized critical vertex
-                    key_vertex = t.TV(i);
-            }
-            if(link_v.size() == 2)
-            {
-                if(field < mesh.get_vertex(link_v[0]).get_c(2) &&
-                        field < mesh.get_vertex(link_v[1]).get_c(2))
-                {
-                    adj_upper[link_v[0]].insert(link_v[1]);
-                    adj_upper[link_v[1]].insert(link_v[0]);
-                }
-                else if(field > mesh.get_vertex(link_v[0]).get_c(2) &&
-                        field > mesh.get_vertex(link_v[1]).get_c(2))
-                {
-                    adj_lower[link_v[0]].insert(link_v[1]);
-                    adj_lower[link_v[1]].insert(link_v[0]);
-                }
+                if(mesh.get_original_vertex_id(vertices[i]) < mesh.get_original_vertex_id(label_v))
+                    label_v = vertices[i];
             }
+            this->critical_points[label_v] = classify_plateau(p,mesh,boundary,parent,slots);
         }
+    }
+}
+
+// the root of the boundary vertex i in the union-find of the boundary
+static inline itype boundary_root(ivect &parent, itype i)
+{
+    while(parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
 
-        if(upper.empty()) //the vertex is a maximum
-            this->critical_points[key_vertex] = Point_Type::MAXIMUM;
-        else if(lower.empty()) //the vertex is a minimum
-            this->critical_points[key_vertex] = Point_Type::MINIMUM;
-        else //we have to check the connected components of the edges in the link
+// the slot of v in a hash table of 2^bits slots (Fibonacci hashing)
+static inline itype boundary_slot(itype v, int bits)
+{
+    return (itype)(((uint64_t)v * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+Point_Type Critical_Points_Extractor::classify_plateau(itype p, Spatial_Mesh &mesh, ivect &boundary, ivect &parent, ivect &slots)
+{
+    const itype *vertices = plateaus.get_vertices(p);
+    coord_type z = mesh.get_vertex(vertices[0]).get_c(2);
+    boundary.clear();
+    parent.clear();
+
+    // the positions in boundary of the boundary vertices, with linear probing (-1 marks a free slot).
+    // The table is kept at most half full, doubling it when needed
+    int bits = 4;
+    while(((itype)1 << bits) < 2*plateaus.get_vertices_num(p))
+        bits++;
+    slots.assign((itype)1 << bits,-1);
+    auto insert = [&](itype pos)
+    {
+        itype mask = slots.size()-1;
+        itype h = boundary_slot(boundary[pos],bits);
+        while(slots[h] != -1)
+            h = (h+1) & mask;
+        slots[h] = pos;
+    };
+    auto add = [&](itype v)
+    {
+        itype mask = slots.size()-1;
+        itype h = boundary_slot(v,bits);
+        while(slots[h] != -1)
+        {
+            if(boundary[slots[h]] == v)
+                return slots[h];
+            h = (h+1) & mask;
+        }
+        itype pos = boundary.size();
+        boundary.push_back(v);
+        parent.push_back(pos);
+        if(2*boundary.size() > slots.size())
         {
-            // merge upper components
-            utype uc_num = get_components_num(adj_upper,upper);
-            // merge lower components
-            utype lc_num = get_components_num(adj_lower,lower);
-
-            if(uc_num == 2 && lc_num == 2) // simple saddle
-                this->critical_points[key_vertex] = Point_Type::SADDLE;
-            else if(uc_num > 2 && lc_num > 2) // multiple saddle
-                this->critical_points[key_vertex] = Point_Type::MULTIPLE_SADDLE;
-            // else the point is already flagged as regular point
+            bits++;
+            slots.assign((itype)1 << bits,-1);
+            for(itype i=0; i<=pos; i++)
+                insert(i);
         }
+        else
+            slots[h] = pos;
+        return pos;
+    };
+
+    // a triangle with a single vertex in the plateau adds an edge of the boundary (visited once, from that vertex),
+    // a triangle with two vertices in the plateau adds a boundary vertex
+    for(itype i=0; i<plateaus.get_vertices_num(p); i++)
+    {
+        itype v = vertices[i];
+        mesh.for_each_VT(v,[&](itype t_id)
+        {
+            Triangle t = mesh.get_triangle(t_id);
+            int k = t.vertex_index(v);
+            itype v1 = t.TV((k+1)%3), v2 = t.TV((k+2)%3);
+            bool in1 = plateaus.get_plateau(v1) == p, in2 = plateaus.get_plateau(v2) == p;
+            if(!in1 && !in2)
+            {
+                itype l1 = add(v1), l2 = add(v2);
+                // an edge joins two upper or two lower vertices (the boundary has no vertex with the plateau value)
+                if((mesh.get_vertex(v1).get_c(2) > z) == (mesh.get_vertex(v2).get_c(2) > z))
+                    parent[boundary_root(parent,l1)] = boundary_root(parent,l2);
+            }
+            else if(!in1)
+                add(v1);
+            else if(!in2)
+                add(v2);
+        });
+    }
 
-        // reset the local d.s.
-        upper.clear();
-        lower.clear();
-        adj_lower.clear();
-        adj_upper.clear();
+    itype uc_num = 0, lc_num = 0;
+    for(itype i=0; i<(itype)boundary.size(); i++)
+    {
+        if(boundary_root(parent,i) == i)
+        {
+            if(mesh.get_vertex(boundary[i]).get_c(2) > z)
+                uc_num++;
+            else
+                lc_num++;
+        }
     }
+
+    if(uc_num == 0) //the plateau is a maximum
+        return Point_Type::MAXIMUM;
+    if(lc_num == 0) //the plateau is a minimum
+        return Point_Type::MINIMUM;
+    if(uc_num == 2 && lc_num == 2) // simple saddle
+        return Point_Type::SADDLE;
+    else if(uc_num > 2 && lc_num > 2) // multiple saddle
+        return Point_Type::MULTIPLE_SADDLE;
+    return Point_Type::REGULAR;
 }
 
 void Critical_Points_Extractor::init_adjacent_vertices(itype v_id, Vertex &v, ivect &vt, Spatial_Mesh &mesh,
@@ -239,7 +380,7 @@ void Critical_Points_Extractor::init_adjacent_vertices(itype v_id, Vertex &v, iv
 {
     for(ivect::iterator it=vt.begin(); it!=vt.end(); ++it)
     {
-        Triangle &t = mesh.get_triangle(*it);
+        Triangle t = mesh.get_triangle(*it);
         int v_pos = t.vertex_index(v_id);
         Edge e = t.TE(v_pos);
 
@@ -28,10 +28,7 @@
 
 #include "ia/mesh.h"
 #include "utilities/basic_wrappers.h"
-
-// the key corresponds to the field value of the flat area
-// the value correspond to the vertices and triangles belonging to the flat area
-typedef map<double,iset> flat_areas;
+#include "terrain_features/plateaus.h"
 
 enum class Point_Type: short {REGULAR=0, MINIMUM=1, SADDLE=2, MULTIPLE_SADDLE=3, MAXIMUM=4};
 
@@ -40,8 +37,11 @@ class Critical_Points_Extractor
 public:
     //
     Critical_Points_Extractor() { }
-    //
-    void compute_critical_points(Spatial_Mesh &mesh);
+    //classifies the vertices with no neighbor with the same field value, and each plateau (see Plateaus)
+    //as a single vertex (its vertex with the lowest input index gets the label, the other vertices of the plateau are regular).
+    //With the simulation of simplicity the ties are broken by the input index of the vertices (the vertices are totally
+    //ordered by (z, input index)), thus each vertex is classified by its link and there are no plateaus
+    void compute_critical_points(Spatial_Mesh &mesh, bool simulation_of_simplicity=false);
     //
     inline void print_stats()
     {
@@ -72,15 +72,44 @@ public:
         cerr<<"   regular_points: "<<num_reg<<" -- minima: "<<num_min<<endl;
         cerr<<"   saddles: "<<num_saddle<<" -- multi-saddles: "<<num_multisaddle<<endl;
         cerr<<"   maxima: "<<num_max<<endl;
+        cerr<<"   plateaus: "<<plateaus.get_plateaus_num()<<" -- flat vertices: "<<plateaus.get_flat_vertices_num()<<endl;
     }
     inline vector<Point_Type>& get_critical_points() { return this->critical_points; }
+    //compares the classification counting the sign changes in the links with the one merging the link components
+    //(the time of each, and the number of different labels)
+    void benchmark(Spatial_Mesh &mesh, int repetitions);
+    //the rank of each vertex in the order by (z, input index), i.e., the total order of the simulation of simplicity
+    static void compute_ranks(Spatial_Mesh &mesh, ivect &ranks);
+    //true if the vertex a precedes b in the order of the simulation of simplicity (the ties are broken on the input
+    //index, thus the order does not change if the mesh is reordered)
+    static inline bool precedes(Spatial_Mesh &mesh, itype a, itype b)
+    {
+        coord_type za = mesh.get_vertex(a).get_c(2), zb = mesh.get_vertex(b).get_c(2);
+        return za < zb || (za == zb && mesh.get_original_vertex_id(a) < mesh.get_original_vertex_id(b));
+    }
 
 private:
     vector<Point_Type> critical_points;
+    Plateaus plateaus;
+    // reusable buffers for the VT and VV relations of the current vertex (used by the serial procedures)
+    ivect vt, vv;
 
-    void extract_critical_points(Spatial_Mesh &mesh, flat_areas &fa); /// buggy
     void extract_critical_points(Spatial_Mesh &mesh);
-    void extract_critical_points_from_flat_areas(flat_areas &fa, Spatial_Mesh &mesh); /// buggy
+    //classifies a vertex from the sign changes of the field (z value) around its ordered link, in O(degree) without allocations
+    //(flat is set if a neighbor has the same field value, and the vertex is left regular)
+    Point_Type classify_vertex(itype v, Spatial_Mesh &mesh, bool &flat);
+    //classifies a vertex from the side (1 upper, -1 lower, 0 same field value) of each vertex w of its link, given by side(w)
+    template<class Side> Point_Type classify_link(itype v, Spatial_Mesh &mesh, Side side, bool &flat);
+    //classifies the vertices comparing their ranks (simulation of simplicity)
+    void extract_critical_points_sos(Spatial_Mesh &mesh);
+    //the previous classification, counting the components of the link with maps and a BFS (used by the benchmark)
+    void extract_critical_points_by_components(Spatial_Mesh &mesh);
+    //classifies the plateaus in parallel
+    void extract_critical_plateaus(Spatial_Mesh &mesh);
+    //classifies a plateau from the components of its boundary (the vertices adjacent to the plateau),
+    //in time linear in the triangles incident in the plateau (boundary, parent and slots are reusable buffers,
+    //slots is a hash table sized on the plateau, mapping the boundary vertices to their positions)
+    Point_Type classify_plateau(itype p, Spatial_Mesh &mesh, ivect &boundary, ivect &parent, ivect &slots);
     void init_adjacent_vertices(itype v_id, Vertex &v, ivect &vt, Spatial_Mesh &mesh, map<itype, iset> &adj_upper,
                                 map<itype, iset> &adj_lower);
     utype get_components_num(map<itype, iset> &adj_map, map<itype, itype> &v_flag);
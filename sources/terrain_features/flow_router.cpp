@@ -0,0 +1,129 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "flow_router.h"
+#include "critical_points_extractor.h"
+#include "utilities/parallel.h"
+#include <algorithm>
+
+void Flow_Router::compute_receivers(Spatial_Mesh &mesh)
+{
+    itype num_v = mesh.get_vertices_num();
+    receivers.assign(num_v,-1);
+    drainage.assign(num_v,0);
+
+    #pragma omp parallel for schedule(dynamic,4096)
+    for(itype v=0; v<num_v; v++)
+    {
+        Vertex &p = mesh.get_vertex(v);
+        coord_type steepest = 0, area = 0;
+        itype receiver = -1;
+        // each neighbor is visited from both its triangles in the star, without changing the result
+        auto candidate = [&](itype w, Vertex &q)
+        {
+            if(!Critical_Points_Extractor::precedes(mesh,w,v))
+                return;
+            coord_type dx = q.get_c(0)-p.get_c(0), dy = q.get_c(1)-p.get_c(1);
+            coord_type slope = (p.get_c(2)-q.get_c(2)) / sqrt(dx*dx+dy*dy);
+            if(receiver == -1 || slope > steepest || (slope == steepest && Critical_Points_Extractor::precedes(mesh,w,receiver)))
+            {
+                receiver = w;
+                steepest = slope;
+            }
+        };
+        mesh.for_each_VT(v,[&](itype t)
+        {
+            Triangle tr = mesh.get_triangle(t);
+            int k = tr.vertex_index(v);
+            itype a = tr.TV((k+1)%3), b = tr.TV((k+2)%3);
+            Vertex &qa = mesh.get_vertex(a), &qb = mesh.get_vertex(b);
+            area += fabs((qa.get_c(0)-p.get_c(0))*(qb.get_c(1)-p.get_c(1)) - (qb.get_c(0)-p.get_c(0))*(qa.get_c(1)-p.get_c(1))) / 6;
+            candidate(a,qa);
+            candidate(b,qb);
+        });
+        receivers[v] = receiver;
+        drainage[v] = area;
+    }
+}
+
+void Flow_Router::compute_accumulation()
+{
+    itype num_v = receivers.size();
+
+    // the donors of each vertex in CSR form, sorted by index
+    ivect offsets(num_v+1,0);
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+    {
+        if(receivers[v] != -1)
+            parallel::fetch_add(offsets[receivers[v]+1],1);
+    }
+    for(itype v=0; v<num_v; v++)
+        offsets[v+1] += offsets[v];
+    ivect donors(offsets[num_v]);
+    ivect next(offsets.begin(),offsets.end()-1);
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+    {
+        if(receivers[v] != -1)
+            donors[parallel::fetch_add(next[receivers[v]],1)] = v;
+    }
+    #pragma omp parallel for schedule(dynamic,4096)
+    for(itype v=0; v<num_v; v++)
+        std::sort(donors.begin()+offsets[v],donors.begin()+offsets[v+1]);
+
+    // the vertices in the order they are accumulated: the vertices of each level are appended after the previous level.
+    // The first level contains the sources (the vertices without donors)
+    ivect order(num_v);
+    itype tail = 0;
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+    {
+        if(offsets[v] == offsets[v+1])
+            order[parallel::fetch_add(tail,1)] = v;
+    }
+
+    // next[v] is now offsets[v+1], and it is decremented for each accumulated donor of v:
+    // v joins the following level when it reaches offsets[v]
+    levels_num = 0;
+    itype begin = 0;
+    while(begin < tail)
+    {
+        itype end = tail;
+        #pragma omp parallel for schedule(dynamic,4096)
+        for(itype i=begin; i<end; i++)
+        {
+            itype v = order[i];
+            coord_type sum = drainage[v];
+            for(itype j=offsets[v]; j<offsets[v+1]; j++)
+                sum += drainage[donors[j]];
+            drainage[v] = sum;
+            itype r = receivers[v];
+            if(r != -1 && parallel::fetch_add(next[r],-1) == offsets[r]+1)
+                order[parallel::fetch_add(tail,1)] = r;
+        }
+        begin = end;
+        levels_num++;
+    }
+}
@@ -0,0 +1,81 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLOW_ROUTER_H
+#define FLOW_ROUTER_H
+
+#include "ia/mesh.h"
+#include "utilities/basic_wrappers.h"
+
+// the flow routing on a terrain: each vertex drains in its steepest descent neighbor (its receiver), and the drainage
+// area of a vertex is the sum of the areas of the vertices draining in it (the area of a vertex is a third of the
+// area of its incident triangles, projected on the xy plane).
+// The vertices are ordered by (z, input index), as with the simulation of simplicity, thus the flat areas are drained
+// following the input index, the receivers never form a cycle and the sinks are the minima of the simulation of simplicity,
+// also if the mesh is reordered
+class Flow_Router
+{
+public:
+    Flow_Router() : levels_num(0) {}
+
+    //finds the receiver and the area of each vertex in parallel, visiting its star once
+    void compute_receivers(Spatial_Mesh &mesh);
+    //accumulates the areas from the sources to the sinks, processing in parallel the vertices whose donors are all
+    //accumulated (one level at a time). Each vertex sums the drainage of its donors in increasing order of index,
+    //thus the result does not depend on the number of threads (requires the receivers)
+    void compute_accumulation();
+
+    inline void print_stats()
+    {
+        itype num_sinks = 0;
+        coord_type total = 0, max = 0;
+        for(itype v=0; v<(itype)receivers.size(); v++)
+        {
+            if(receivers[v] == -1)
+            {
+                num_sinks++;
+                total += drainage[v];
+            }
+            max = std::max(max,drainage[v]);
+        }
+        cerr<<"[STAT] Flow accumulation"<<endl;
+        cerr<<"   sinks: "<<num_sinks<<" -- levels: "<<levels_num<<endl;
+        cerr<<"   max drainage area: "<<max<<" -- drained area: "<<total<<endl;
+    }
+
+    //the vertex receiving the flow of v, -1 if v is a sink (it has no lower neighbor)
+    inline itype get_receiver(itype v) { return receivers[v]; }
+    inline dvect& get_drainage_areas() { return drainage; }
+    //the number of parallel steps of the accumulation (the length of the longest flow path)
+    inline itype get_levels_num() { return levels_num; }
+    inline size_t get_storage_size() { return sizeof(itype) * receivers.capacity() + sizeof(coord_type) * drainage.capacity(); }
+
+private:
+    ivect receivers;
+    // the area of each vertex, then its drainage area
+    dvect drainage;
+    itype levels_num;
+};
+
+#endif // FLOW_ROUTER_H
@@ -0,0 +1,369 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "forman_gradient.h"
+#include "critical_points_extractor.h"
+#include "utilities/parallel.h"
+#include <algorithm>
+#include <functional>
+
+void Forman_Gradient::compute_gradient(Spatial_Mesh &mesh)
+{
+    mesh.build_edges_index();
+    ivect ranks;
+    Critical_Points_Extractor::compute_ranks(mesh,ranks);
+
+    itype num_v = mesh.get_vertices_num();
+    itype num_e = mesh.get_edges_num();
+    itype num_t = mesh.get_triangles_num();
+    vertex_pair.assign(num_v,-1);
+    edge_pair.assign(num_e,-1);
+    triangle_pair.assign(num_t,-1);
+
+    // each vertex pairs only the cells of its lower star, thus the result does not depend on the schedule
+    #pragma omp parallel
+    {
+        Lower_Star star;
+        #pragma omp for schedule(dynamic,4096)
+        for(itype v=0; v<num_v; v++)
+            process_lower_star(v,mesh,ranks,star);
+    }
+
+    critical_vertices.clear();
+    critical_edges.clear();
+    critical_triangles.clear();
+    for(itype v=0; v<num_v; v++)
+    {
+        if(vertex_pair[v] == -1)
+            critical_vertices.push_back(v);
+    }
+    for(itype e=0; e<num_e; e++)
+    {
+        if(edge_pair[e] == -1)
+            critical_edges.push_back(e);
+    }
+    for(itype t=0; t<num_t; t++)
+    {
+        if(triangle_pair[t] == -1)
+            critical_triangles.push_back(t);
+    }
+
+    // on a reordered mesh the critical cells are sorted by their input index (the edges by the input indices of their
+    // extremes), thus the positions of the extrema, labeling the regions, do not depend on the order
+    if(mesh.has_original_ids())
+    {
+        std::sort(critical_vertices.begin(),critical_vertices.end(),[&mesh](itype a, itype b)
+        {
+            return mesh.get_original_vertex_id(a) < mesh.get_original_vertex_id(b);
+        });
+        std::sort(critical_triangles.begin(),critical_triangles.end(),[&mesh](itype a, itype b)
+        {
+            return mesh.get_original_triangle_id(a) < mesh.get_original_triangle_id(b);
+        });
+        auto input_extremes = [&mesh](itype e)
+        {
+            Edge ed = mesh.EV(e);
+            itype u = mesh.get_original_vertex_id(ed.EV(0)), w = mesh.get_original_vertex_id(ed.EV(1));
+            return std::make_pair(std::min(u,w),std::max(u,w));
+        };
+        std::sort(critical_edges.begin(),critical_edges.end(),[&input_extremes](itype a, itype b)
+        {
+            return input_extremes(a) < input_extremes(b);
+        });
+    }
+}
+
+// the lower stars with up to SMALL_LOWER_STAR cells (most of the ones of a terrain) are sorted and searched linearly
+#define SMALL_LOWER_STAR 16
+
+// sorts the cells of a lower star, by insertion on the small ones
+template<class T, class C> static void sort_cells(vector<T> &cells, C less)
+{
+    if(cells.size() > SMALL_LOWER_STAR)
+    {
+        std::sort(cells.begin(),cells.end(),less);
+        return;
+    }
+    for(size_t i=1; i<cells.size(); i++)
+    {
+        T c = cells[i];
+        size_t j = i;
+        for(; j>0 && less(c,cells[j-1]); j--)
+            cells[j] = cells[j-1];
+        cells[j] = c;
+    }
+}
+
+void Forman_Gradient::process_lower_star(itype v, Spatial_Mesh &mesh, const ivect &ranks, Lower_Star &star)
+{
+    itype rank = ranks[v];
+    vector<Lower_Cell> &edges = star.edges, &triangles = star.triangles;
+    edges.clear();
+    triangles.clear();
+
+    // the edges (v,w) with w lower than v, each one added by the triangle owning it
+    mesh.for_each_VT(v,[&](itype t)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        int k = tr.vertex_index(v);
+        for(int j=1; j<3; j++)
+        {
+            // the edge (v,w) is opposite to the third vertex of t
+            itype w = tr.TV((k+j)%3);
+            int pos = (k+3-j)%3;
+            if(ranks[w] < rank && mesh.is_edge_owner(t,pos))
+                edges.push_back({(int64_t)ranks[w] << 32, mesh.edge_id(t,pos), w, {-1,-1}, UNASSIGNED});
+        }
+    });
+    if(edges.empty())
+        return; // v is a minimum
+
+    auto by_key = [](const Lower_Cell &a, const Lower_Cell &b) { return a.key < b.key; };
+    // the keys of the edges are distinct (the ranks of the vertices are)
+    sort_cells(edges,by_key);
+    auto find_edge = [&edges,&ranks,&by_key](itype w)
+    {
+        if(edges.size() <= SMALL_LOWER_STAR)
+        {
+            int i = 0;
+            while(edges[i].w != w)
+                i++;
+            return i;
+        }
+        Lower_Cell key = {(int64_t)ranks[w] << 32, -1, -1, {-1,-1}, UNASSIGNED};
+        return (int)(std::lower_bound(edges.begin(),edges.end(),key,by_key) - edges.begin());
+    };
+    // the triangles (v,a,b) with a and b lower than v
+    mesh.for_each_VT(v,[&](itype t)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        int k = tr.vertex_index(v);
+        itype a = ranks[tr.TV((k+1)%3)], b = ranks[tr.TV((k+2)%3)];
+        if(a > rank || b > rank)
+            return;
+        triangles.push_back({((int64_t)std::max(a,b) << 32) | (std::min(a,b)+1), t, -1,
+                             {find_edge(tr.TV((k+1)%3)),find_edge(tr.TV((k+2)%3))}, UNASSIGNED});
+    });
+    // equal keys (the same two vertices, on a non-manifold star) are ordered by triangle
+    sort_cells(triangles,[](const Lower_Cell &a, const Lower_Cell &b)
+    {
+        return a.key < b.key || (a.key == b.key && a.id < b.id);
+    });
+    for(int c=0; c<(int)triangles.size(); c++)
+    {
+        for(int f : triangles[c].adj)
+            edges[f].adj[(edges[f].adj[0] == -1) ? 0 : 1] = c;
+    }
+
+    // the heaps return the lowest position first
+    vector<int> &queue_one = star.queue_one, &queue_zero = star.queue_zero;
+    queue_one.clear();
+    queue_zero.clear();
+    auto push = [](vector<int> &queue, int c)
+    {
+        queue.push_back(c);
+        std::push_heap(queue.begin(),queue.end(),std::greater<int>());
+    };
+    auto pop = [](vector<int> &queue)
+    {
+        std::pop_heap(queue.begin(),queue.end(),std::greater<int>());
+        int c = queue.back();
+        queue.pop_back();
+        return c;
+    };
+    // the triangles incident in the edge e with a single unassigned edge are ready to be paired
+    auto queue_cofaces = [&](int e)
+    {
+        for(int c : edges[e].adj)
+        {
+            if(c != -1 && triangles[c].state == UNASSIGNED && get_unpaired_faces_num(triangles[c],edges) == 1)
+            {
+                triangles[c].state = QUEUED_ONE;
+                push(queue_one,c);
+            }
+        }
+    };
+
+    // v is paired with its steepest edge (the first one), and the other edges wait to be paired or declared critical:
+    // the edges only leave the waiting state, thus the lowest waiting one is found by a cursor
+    vertex_pair[v] = edges[0].id;
+    edge_pair[edges[0].id] = -(v+2);
+    for(auto &e : edges)
+        e.state = QUEUED_ZERO;
+    edges[0].state = ASSIGNED;
+    queue_cofaces(0);
+    int next_edge = 1;
+
+    while(true)
+    {
+        while(!queue_one.empty())
+        {
+            int alpha = pop(queue_one);
+            Lower_Cell &t = triangles[alpha];
+            if(get_unpaired_faces_num(t,edges) == 0)
+            {
+                t.state = QUEUED_ZERO;
+                push(queue_zero,alpha);
+                continue;
+            }
+            int beta = (edges[t.adj[0]].state != ASSIGNED) ? t.adj[0] : t.adj[1];
+            triangle_pair[t.id] = edges[beta].id;
+            edge_pair[edges[beta].id] = t.id;
+            t.state = ASSIGNED;
+            edges[beta].state = ASSIGNED;
+            queue_cofaces(beta);
+        }
+
+        // the lowest waiting cell is critical (the pairs are initialized as critical)
+        while(next_edge < (int)edges.size() && edges[next_edge].state != QUEUED_ZERO)
+            next_edge++;
+        int e = (next_edge < (int)edges.size()) ? next_edge : -1;
+        int t = queue_zero.empty() ? -1 : queue_zero.front();
+        if(e == -1 && t == -1)
+            break;
+        if(e != -1 && (t == -1 || edges[e].key < triangles[t].key))
+        {
+            edges[e].state = ASSIGNED;
+            queue_cofaces(e);
+        }
+        else
+            triangles[pop(queue_zero)].state = ASSIGNED;
+    }
+}
+
+template<class Start, class Next> void Forman_Gradient::trace_separatrices(Separatrices &separatrices, Start start, Next next)
+{
+    // follows the V-path from c until a critical cell or the border, saving its cells if requested
+    auto follow = [&next](itype c, itype *cells)
+    {
+        itype len = 0;
+        while(true)
+        {
+            if(cells != NULL)
+                cells[len] = c;
+            len++;
+            itype n = next(c);
+            if(n == c || n == -1)
+                return len;
+            c = n;
+        }
+    };
+
+    itype num_s = critical_edges.size();
+    // the length of the (up to two) separatrices of each saddle, 0 if missing
+    ivect lengths(2*num_s,0);
+    #pragma omp parallel for schedule(dynamic,64)
+    for(itype s=0; s<num_s; s++)
+    {
+        itype first[2];
+        int num = start(critical_edges[s],first);
+        for(int j=0; j<num; j++)
+            lengths[2*s+j] = follow(first[j],NULL);
+    }
+
+    separatrices.saddles.clear();
+    separatrices.offsets.assign(1,0);
+    for(itype i=0; i<2*num_s; i++)
+    {
+        if(lengths[i] == 0)
+            continue;
+        separatrices.saddles.push_back(critical_edges[i/2]);
+        separatrices.offsets.push_back(separatrices.offsets.back()+lengths[i]);
+        // from now on, the starting position of the separatrix
+        lengths[i] = separatrices.offsets[separatrices.offsets.size()-2];
+    }
+    separatrices.cells.resize(separatrices.offsets.back());
+
+    #pragma omp parallel for schedule(dynamic,64)
+    for(itype s=0; s<num_s; s++)
+    {
+        itype first[2];
+        int num = start(critical_edges[s],first);
+        for(int j=0; j<num; j++)
+            follow(first[j],&separatrices.cells[lengths[2*s+j]]);
+    }
+}
+
+template<class Next> void Forman_Gradient::label_regions(itype num, ivect &critical, ivect &region, Next next)
+{
+    // the last cell of the V-path of each cell, doubling the length of the jumps at each round
+    ivect target(num), jumped(num);
+    #pragma omp parallel for schedule(static)
+    for(itype i=0; i<num; i++)
+        target[i] = next(i);
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        #pragma omp parallel for schedule(static) reduction(||:changed)
+        for(itype i=0; i<num; i++)
+        {
+            itype t = target[i];
+            jumped[i] = (t == -1) ? -1 : target[t];
+            if(jumped[i] != t)
+                changed = true;
+        }
+        target.swap(jumped);
+    }
+
+    // jumped is reused for the positions of the critical cells
+    for(itype i=0; i<(itype)critical.size(); i++)
+        jumped[critical[i]] = i;
+    region.resize(num);
+    #pragma omp parallel for schedule(static)
+    for(itype i=0; i<num; i++)
+        region[i] = (target[i] == -1) ? -1 : jumped[target[i]];
+}
+
+void Forman_Gradient::compute_morse_smale(Spatial_Mesh &mesh)
+{
+    // the descending separatrices start from the extremes of the saddle, and reach a minimum
+    trace_separatrices(descending,[&mesh](itype e, itype *first)
+    {
+        Edge ed = mesh.EV(e);
+        first[0] = ed.EV(0);
+        first[1] = ed.EV(1);
+        return 2;
+    },[this,&mesh](itype v) { return next_vertex(v,mesh); });
+    // the ascending separatrices start from the triangles incident in the saddle, and reach a maximum or the border
+    trace_separatrices(ascending,[&mesh](itype e, itype *first)
+    {
+        mesh.ET(e,first[0],first[1]);
+        return (first[1] == -1) ? 1 : 2;
+    },[this,&mesh](itype t) { return next_triangle(t,mesh); });
+
+    label_regions(mesh.get_vertices_num(),critical_vertices,vertex_region,[this,&mesh](itype v) { return next_vertex(v,mesh); });
+    label_regions(mesh.get_triangles_num(),critical_triangles,triangle_region,[this,&mesh](itype t) { return next_triangle(t,mesh); });
+}
+
+itype Forman_Gradient::get_border_separatrices_num()
+{
+    itype num = 0;
+    for(itype s=0; s<ascending.get_separatrices_num(); s++)
+    {
+        if(triangle_pair[ascending.cells[ascending.offsets[s+1]-1]] != -1)
+            num++;
+    }
+    return num;
+}
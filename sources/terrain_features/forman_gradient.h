@@ -0,0 +1,168 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FORMAN_GRADIENT_H
+#define FORMAN_GRADIENT_H
+
+#include "ia/mesh.h"
+#include "utilities/basic_wrappers.h"
+
+// the separatrices of one kind in CSR form: the separatrix s starts from the critical edge saddles[s] and its cells
+// are in [offsets[s],offsets[s+1]) of the cells array (the vertices of a descending separatrix, ending in a minimum,
+// or the triangles of an ascending one, ending in a maximum or in a triangle on the border)
+struct Separatrices
+{
+    ivect saddles, offsets, cells;
+
+    Separatrices() : offsets(1,0) {}
+    inline itype get_separatrices_num() { return saddles.size(); }
+    inline size_t get_storage_size()
+    {
+        return sizeof(itype) * (saddles.capacity() + offsets.capacity() + cells.capacity());
+    }
+};
+
+// the discrete gradient of Forman of a terrain, and the Morse-Smale complex extracted from it.
+// The vertices are totally ordered by (z, input index), as with the simulation of simplicity of the Critical_Points_Extractor,
+// and the gradient pairs the cells in the lower star of each vertex (the cells having it as their highest vertex).
+// The pairs are encoded on the IA with one integer for each vertex, edge (following the edges index) and triangle
+class Forman_Gradient
+{
+public:
+    Forman_Gradient() {}
+
+    //pairs the cells of the lower star of each vertex, in parallel (each cell is in the lower star of one vertex,
+    //thus the gradient does not depend on the number of threads), and collects the critical cells
+    void compute_gradient(Spatial_Mesh &mesh);
+    //traces the separatrices from the critical edges (the V-paths down to the minima and up to the maxima)
+    //and labels the 2-cells: each vertex with its minimum, and each triangle with its maximum (requires the gradient)
+    void compute_morse_smale(Spatial_Mesh &mesh);
+
+    inline void print_stats(Spatial_Mesh &mesh)
+    {
+        itype num_min = critical_vertices.size(), num_saddle = critical_edges.size(), num_max = critical_triangles.size();
+        cerr<<"[STAT] Forman gradient"<<endl;
+        cerr<<"   minima: "<<num_min<<" -- saddles: "<<num_saddle<<" -- maxima: "<<num_max<<endl;
+        // the critical cells have the same Euler characteristic of the mesh
+        cerr<<"   euler characteristic: "<<num_min-num_saddle+num_max<<" (mesh: "
+            <<mesh.get_vertices_num()-mesh.get_edges_num()+mesh.get_triangles_num()<<")"<<endl;
+        if(descending.get_separatrices_num() == 0 && ascending.get_separatrices_num() == 0)
+            return;
+        cerr<<"[STAT] Morse-Smale complex"<<endl;
+        cerr<<"   descending separatrices: "<<descending.get_separatrices_num()<<" -- vertices: "<<descending.cells.size()<<endl;
+        cerr<<"   ascending separatrices: "<<ascending.get_separatrices_num()<<" -- triangles: "<<ascending.cells.size()
+            <<" -- reaching the border: "<<get_border_separatrices_num()<<endl;
+    }
+
+    //the edge paired with a vertex, -1 if the vertex is critical (a minimum)
+    inline itype get_vertex_pair(itype v) { return vertex_pair[v]; }
+    //the triangle paired with an edge if not negative, otherwise -1 if the edge is critical (a saddle),
+    //or the vertex v, encoded as -(v+2), paired with the edge
+    inline itype get_edge_pair(itype e) { return edge_pair[e]; }
+    //the edge paired with a triangle, -1 if the triangle is critical (a maximum)
+    inline itype get_triangle_pair(itype t) { return triangle_pair[t]; }
+
+    //the critical cells, in increasing order of input index
+    inline ivect& get_critical_vertices() { return critical_vertices; }
+    inline ivect& get_critical_edges() { return critical_edges; }
+    inline ivect& get_critical_triangles() { return critical_triangles; }
+
+    inline Separatrices& get_descending_separatrices() { return descending; }
+    inline Separatrices& get_ascending_separatrices() { return ascending; }
+    //the position in the critical vertices of the minimum reached by the V-path of each vertex
+    inline ivect& get_vertex_regions() { return vertex_region; }
+    //the position in the critical triangles of the maximum reached by the V-path of each triangle
+    //(-1 if the V-path leaves the mesh through the border)
+    inline ivect& get_triangle_regions() { return triangle_region; }
+
+    inline size_t get_gradient_storage_size()
+    {
+        return sizeof(itype) * (vertex_pair.capacity() + edge_pair.capacity() + triangle_pair.capacity() +
+                                critical_vertices.capacity() + critical_edges.capacity() + critical_triangles.capacity());
+    }
+    inline size_t get_complex_storage_size()
+    {
+        return descending.get_storage_size() + ascending.get_storage_size() +
+                sizeof(itype) * (vertex_region.capacity() + triangle_region.capacity());
+    }
+
+private:
+    ivect vertex_pair, edge_pair, triangle_pair;
+    ivect critical_vertices, critical_edges, critical_triangles;
+    Separatrices descending, ascending;
+    ivect vertex_region, triangle_region;
+
+    // a cell of the lower star of a vertex v: an edge (v,w), with the (up to two) triangles of the lower star
+    // incident in it, or a triangle (v,a,b), with its two edges (positions in the edges of the lower star).
+    // The cells are compared by the ranks of their vertices other than v, in decreasing order (the key)
+    struct Lower_Cell
+    {
+        int64_t key;
+        itype id, w;
+        int adj[2];
+        char state;
+    };
+    enum Cell_State : char {UNASSIGNED=0, QUEUED_ONE=1, QUEUED_ZERO=2, ASSIGNED=3};
+    // the reusable buffers of a thread: the cells of a lower star, sorted by key (thus a position order is the key order),
+    // and the priority queues of the triangles with one and zero unassigned edges (binary heaps of positions)
+    struct Lower_Star
+    {
+        vector<Lower_Cell> edges, triangles;
+        vector<int> queue_one, queue_zero;
+    };
+
+    //the procedure of Robins et al. pairing the cells of the lower star of v, in O(d log d) on a lower star with d cells
+    void process_lower_star(itype v, Spatial_Mesh &mesh, const ivect &ranks, Lower_Star &star);
+    //the number of unassigned edges of a triangle of the lower star
+    inline int get_unpaired_faces_num(Lower_Cell &t, vector<Lower_Cell> &edges)
+    {
+        return (edges[t.adj[0]].state != ASSIGNED) + (edges[t.adj[1]].state != ASSIGNED);
+    }
+    //the next vertex on the descending V-path from v (v itself if it is a minimum)
+    inline itype next_vertex(itype v, Spatial_Mesh &mesh)
+    {
+        if(vertex_pair[v] == -1)
+            return v;
+        Edge e = mesh.EV(vertex_pair[v]);
+        return (e.EV(0) == v) ? e.EV(1) : e.EV(0);
+    }
+    //the next triangle on the ascending V-path from t (t itself if it is a maximum, -1 if the path leaves the mesh)
+    inline itype next_triangle(itype t, Spatial_Mesh &mesh)
+    {
+        if(triangle_pair[t] == -1)
+            return t;
+        itype t1, t2;
+        mesh.ET(triangle_pair[t],t1,t2);
+        return (t1 == t) ? t2 : t1;
+    }
+    //the triangles on the border of the mesh reached by the ascending separatrices
+    itype get_border_separatrices_num();
+    //traces the separatrices of one kind: the first cells of the separatrices starting from the saddle s are given by
+    //start(s,cells) and each path is followed with next (in two passes, sizing the separatrices and then filling them)
+    template<class Start, class Next> void trace_separatrices(Separatrices &separatrices, Start start, Next next);
+    //labels each cell with the position, in critical, of the last cell reached following next (by pointer jumping)
+    template<class Next> void label_regions(itype num, ivect &critical, ivect &region, Next next);
+};
+
+#endif // FORMAN_GRADIENT_H
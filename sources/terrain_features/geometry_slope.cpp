@@ -25,48 +25,39 @@
 
 coord_type Geometry_Slope::compute_triangle_slope(Triangle &t, Spatial_Mesh &mesh)
 {
-    Vertex &v1 = mesh.get_vertex(t.TV(0));
-    Vertex &v2 = mesh.get_vertex(t.TV(1));
-    Vertex &v3 = mesh.get_vertex(t.TV(2));
+    Vec3 v1 = mesh.get_vertex(t.TV(0));
 
     // get the two vectors in the triangle
-    Vertex u = v2 - v1;
-    Vertex v = v3 - v1;
+    Vec3 u = Vec3(mesh.get_vertex(t.TV(1))) - v1;
+    Vec3 v = Vec3(mesh.get_vertex(t.TV(2))) - v1;
 
     // get the cross product to get the normal
-    dvect n = { u.get_c(1)*v.get_c(2) - u.get_c(2)*v.get_c(1) ,
-                u.get_c(2)*v.get_c(0) - u.get_c(0)*v.get_c(2),
-                u.get_c(0)*v.get_c(1) - u.get_c(1)*v.get_c(0) };
-    // get the magnitude of the normal
-    coord_type magnitude_n = sqrt( n[0]*n[0] + n[1]*n[1] + n[2]*n[2] );
+    Vec3 n = u.cross(v);
 
     // the dot product between n and the ground normal is only formed by the normalized y component of n
-    n[1] /= magnitude_n;
     // thus, we do not have to compute the real dot product but we use the y part of the norm
-    coord_type angle = acos(n[1]);
+    coord_type angle = acos(n.y / n.norm());
 
     return angle;
 }
 
 coord_type Geometry_Slope::compute_edge_slope(Edge &e, Spatial_Mesh &mesh)
 {
-    Vertex &v1 = mesh.get_vertex(e.EV(0));
-    Vertex &v2 = mesh.get_vertex(e.EV(1));
-    Vertex v3 = Vertex(v1.get_c(0),v1.get_c(1),v2.get_c(2)); // temp vertex to get a ground
-
-    // get the two vectors in the triangle
-    Vertex u = v2 - v1;
-    Vertex v = v3 - v1;
-
-    coord_type u_mag = u.norm();
-    u /= u_mag;
+    return acos(compute_edge_slope_cosinus(e,mesh));
+}
 
-    coord_type v_mag = v.norm();
-    v /= v_mag;
+coord_type Geometry_Slope::compute_edge_slope_cosinus(Edge &e, Spatial_Mesh &mesh)
+{
+    Vec3 v1 = mesh.get_vertex(e.EV(0));
+    Vec3 v2 = mesh.get_vertex(e.EV(1));
+    Vec3 v3 = Vec3(v1.x,v1.y,v2.z); // temp vertex to get a ground
 
-    coord_type prod = u.scalar_product(v);
+    // get the two vectors in the triangle
+    Vec3 u = v2 - v1;
+    Vec3 v = v3 - v1;
 
-    coord_type angle = acos(prod);
+    u /= u.norm();
+    v /= v.norm();
 
-    return angle;
+    return u.dot(v);
 }
@@ -26,6 +26,7 @@
 
 #include "utilities/basic_wrappers.h"
 #include "ia/mesh.h"
+#include "ia/vec.h"
 
 class Geometry_Slope
 {
@@ -33,6 +34,8 @@ public:
     static coord_type compute_triangle_slope(Triangle &t, Spatial_Mesh &mesh);
 
     static coord_type compute_edge_slope(Edge &e, Spatial_Mesh &mesh);
+    //the cosinus of the slope of the edge (i.e., the argument of acos in compute_edge_slope)
+    static coord_type compute_edge_slope_cosinus(Edge &e, Spatial_Mesh &mesh);
 
 private:
     Geometry_Slope() {}
@@ -0,0 +1,112 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plateaus.h"
+#include "utilities/parallel.h"
+
+itype Plateaus::find(ivect &parent, itype v)
+{
+    itype p = parallel::atomic_load(parent[v]);
+    while(p != v)
+    {
+        // the parent of a vertex can only decrease, thus the grandparent is a valid parent
+        itype gp = parallel::atomic_load(parent[p]);
+        if(gp != p)
+            parallel::compare_and_swap(parent[v],p,gp);
+        v = p;
+        p = gp;
+    }
+    return v;
+}
+
+void Plateaus::unite(ivect &parent, itype u, itype v)
+{
+    while(true)
+    {
+        u = find(parent,u);
+        v = find(parent,v);
+        if(u == v)
+            return;
+        if(u < v)
+            std::swap(u,v);
+        // u is still a root if no other thread has linked it in the meantime
+        if(parallel::compare_and_swap(parent[u],u,v))
+            return;
+    }
+}
+
+void Plateaus::compute(Spatial_Mesh &mesh)
+{
+    itype num_v = mesh.get_vertices_num();
+    itype num_t = mesh.get_triangles_num();
+    ivect parent(num_v);
+    #pragma omp parallel for schedule(static)
+    for(itype v=0; v<num_v; v++)
+        parent[v] = v;
+
+    // each edge is visited by the triangle with the lowest index among the two sharing it
+    #pragma omp parallel for schedule(static)
+    for(itype t=0; t<num_t; t++)
+    {
+        Triangle tr = mesh.get_triangle(t);
+        for(int k=0; k<3; k++)
+        {
+            itype adj = tr.TT(k);
+            if(adj != -1 && adj < t)
+                continue;
+            itype u = tr.TV((k+1)%3), v = tr.TV((k+2)%3);
+            if(mesh.get_vertex(u).get_c(2) == mesh.get_vertex(v).get_c(2))
+                unite(parent,u,v);
+        }
+    }
+
+    // the roots are final: the size of each component is counted on its root
+    ivect size(num_v,0);
+    for(itype v=0; v<num_v; v++)
+    {
+        parent[v] = find(parent,v);
+        size[parent[v]]++;
+    }
+    offsets.assign(1,0);
+    plateau_of.assign(num_v,-1);
+    for(itype v=0; v<num_v; v++)
+    {
+        if(size[v] > 1)
+        {
+            plateau_of[v] = offsets.size()-1;
+            offsets.push_back(offsets.back()+size[v]);
+        }
+    }
+    vertices.resize(offsets.back());
+    ivect next(offsets.begin(),offsets.end()-1);
+    for(itype v=0; v<num_v; v++)
+    {
+        itype p = plateau_of[parent[v]];
+        if(p != -1)
+        {
+            plateau_of[v] = p;
+            vertices[next[p]++] = v;
+        }
+    }
+}
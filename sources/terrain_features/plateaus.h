@@ -0,0 +1,65 @@
+/*
+    This file is part of the LibTri library.
+
+    Author(s): Riccardo Fellegara (riccardo.fellegara@gmail.com)
+               Paola Magillo (paola.magillo@unige.it)
+
+    This project has been supported by the Italian Ministry of Education and
+    Research under the PRIN 2009 program, and by the National Science Foundation
+    under grant number IIS-1116747.
+
+    The LibTri library is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    The LibTri library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with the LibTri library.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLATEAUS_H
+#define PLATEAUS_H
+
+#include "ia/mesh.h"
+
+// the plateaus of a terrain: the connected components of (at least two) vertices joined by edges
+// with the same field value (z), stored in CSR form (the vertices of the plateau p are in
+// [offsets[p],offsets[p+1]) of the vertices array, in increasing order)
+class Plateaus
+{
+public:
+    Plateaus() : offsets(1,0) {}
+
+    //finds the plateaus with a parallel union-find on the edges of the triangles (visited with the TT relation):
+    //the root of each component is its lowest vertex, thus the plateaus are numbered by their lowest vertex
+    //and the result does not depend on the number of threads
+    void compute(Spatial_Mesh &mesh);
+
+    inline itype get_plateaus_num() { return offsets.size()-1; }
+    //the plateau of a vertex, -1 if it has no neighbor with the same field value
+    inline itype get_plateau(itype v) { return plateau_of[v]; }
+    inline itype get_vertices_num(itype p) { return offsets[p+1]-offsets[p]; }
+    inline const itype* get_vertices(itype p) { return &vertices[offsets[p]]; }
+    //the total number of vertices in the plateaus
+    inline itype get_flat_vertices_num() { return vertices.size(); }
+    inline size_t get_storage_size()
+    {
+        return sizeof(itype) * (offsets.capacity() + vertices.capacity() + plateau_of.capacity());
+    }
+
+private:
+    ivect offsets, vertices;
+    ivect plateau_of;
+
+    //the root of the component of v, halving the path to the root
+    static itype find(ivect &parent, itype v);
+    //merges the components of u and v, linking the highest root to the lowest one
+    static void unite(ivect &parent, itype u, itype v);
+};
+
+#endif // PLATEAUS_H
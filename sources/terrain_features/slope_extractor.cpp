@@ -22,16 +22,24 @@
  */
 
 #include "slope_extractor.h"
+#include "utilities/parallel.h"
+#include "utilities/trig_kernels.h"
 
 void Slope_Extractor::compute_triangles_slopes(Spatial_Mesh& mesh)
 {
-    t_slopes.assign(mesh.get_triangles_num(),0);
+    itype num_t = mesh.get_triangles_num();
+    t_slopes.assign(num_t,0);
 
-    for(itype t = 0; t < mesh.get_triangles_num(); t++)
-    {
-        Triangle& tr = mesh.get_triangle(t);
-        t_slopes[t] = Geometry_Slope::compute_triangle_slope(tr,mesh);
+    // the slope is the angle between the triangle normal and the y axis (see Geometry_Slope::compute_triangle_slope),
+    // the arccosinus of the normals of the mesh are computed by the SIMD kernels
+    Normal_Field &normals = mesh.get_normal_field(false);
+    #pragma omp parallel for schedule(static)
+    for(itype t = 0; t < num_t; t++)
+        t_slopes[t] = normals.get_triangle_normal(t).y;
+    trig_kernels::acos(t_slopes.data(),t_slopes.data(),num_t);
 
+    for(itype t = 0; t < num_t; t++)
+    {
         if(t_slopes[t] < this->min)
             this->min = t_slopes[t];
         if(t_slopes[t] > this->max)
@@ -41,31 +49,31 @@ void Slope_Extractor::compute_triangles_slopes(Spatial_Mesh& mesh)
 
     print_slopes_stats(mesh.get_triangles_num());
     reset_stats();
-    t_slopes.clear();
 }
 
 void Slope_Extractor::compute_edges_slopes(Spatial_Mesh& mesh)
 {
-    for(itype t = 0; t < mesh.get_triangles_num(); t++)
+    mesh.build_edges_index();
+    itype num_e = mesh.get_edges_num();
+    e_slopes.assign(num_e,0);
+
+    #pragma omp parallel for schedule(static)
+    for(itype e_id = 0; e_id < num_e; e_id++)
+    {
+        Edge e = mesh.EV(e_id);
+        e_slopes[e_id] = Geometry_Slope::compute_edge_slope_cosinus(e,mesh);
+    }
+    trig_kernels::acos(e_slopes.data(),e_slopes.data(),num_e);
+
+    for(itype e_id = 0; e_id < num_e; e_id++)
     {
-        Triangle& tr = mesh.get_triangle(t);
-        for(int v=0; v<tr.vertices_num(); v++)
-        {
-            Edge e = tr.TE(v);
-            if(e_slopes.find(e)==e_slopes.end())
-            {
-                coord_type s = Geometry_Slope::compute_edge_slope(e,mesh);
-                e_slopes.insert(make_pair(e,s));
-                if(s < this->min)
-                    this->min = s;
-                if(s > this->max)
-                    this->max = s;
-                this->avg += s;
-            }
-        }
+        if(e_slopes[e_id] < this->min)
+            this->min = e_slopes[e_id];
+        if(e_slopes[e_id] > this->max)
+            this->max = e_slopes[e_id];
+        this->avg += e_slopes[e_id];
     }
 
-    print_slopes_stats(e_slopes.size());
+    print_slopes_stats(mesh.get_edges_num());
     reset_stats();
-    e_slopes.clear();
 }
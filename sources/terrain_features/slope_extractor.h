@@ -47,6 +47,10 @@ public:
 
     inline void print_slopes_stats(utype num) { cerr<<"   min: "<<min<<" avg: "<<avg/(coord_type)num<<" max: "<<max<<endl; }
 
+    //the slopes of the last computation, indexed by triangle and by edge (see Mesh::EV)
+    inline const dvect& get_triangles_slopes() { return t_slopes; }
+    inline const dvect& get_edges_slopes() { return e_slopes; }
+
     inline void reset_stats()
     {
         min = INT_MAX;
@@ -56,7 +60,7 @@ public:
 
 
 private:
-    map<Edge,coord_type> e_slopes;
+    dvect e_slopes; // indexed by the edge index of the mesh
     dvect t_slopes;
     coord_type min, avg, max;
 };
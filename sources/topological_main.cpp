@@ -29,91 +29,121 @@
 #include "ia/mesh.h"
 #include "utilities/usage.h"
 #include "utilities/timer.h"
+#include "utilities/parallel.h"
 
 template<class M> void VT_ALL(M& mesh);
 template<class M> void ALL(M& mesh);
 
-template<class M> void ALL(M& mesh)
+///A struct containing the reusable buffers and the counters of a thread during a batched extraction
+struct Batch_Worker
+{
+    ivect ret_v;
+    vector<Edge> ret_e;
+    size_t relations = 0; // number of extracted relations
+    size_t entries = 0; // number of simplices contained in the extracted relations
+    double time = 0;
+};
+
+/**
+ * @brief A procedure that executes a batched extraction, distributing the ids in [0,num) among the threads
+ * and printing the per-thread and the aggregate throughput (relations/sec)
+ *
+ * @param name the name of the extracted relation
+ * @param num the number of ids to process
+ * @param extract a functor called as extract(id,worker) that extracts the relations of id
+ */
+template<class F> void batched_extraction(string name, itype num, F extract)
 {
+    vector<Batch_Worker> workers(parallel::get_threads_num());
     Timer time;
     time.start();
-    bool is_border;
-    for(int vid=0; vid<mesh.get_vertices_num(); vid++)
+    #pragma omp parallel
     {
-        ivect ret = mesh.VT(vid,is_border);
-        ret.clear();
+        // the worker lives on the stack of its thread while extracting, so that the counters of
+        // different threads, updated once per id, do not share a cache line
+        Batch_Worker w;
+        Timer t_time;
+        t_time.start();
+        #pragma omp for schedule(dynamic,4096) nowait
+        for(itype id=0; id<num; id++)
+            extract(id,w);
+        t_time.stop();
+        w.time = t_time.get_elapsed_time();
+        workers[parallel::get_thread_id()] = std::move(w);
     }
     time.stop();
-    time.print_elapsed_time("[TIME] batched VT extraction: ");
+    time.print_elapsed_time("[TIME] batched "+name+" extraction: ");
+
+    size_t relations = 0, entries = 0;
+    for(utype i=0; i<workers.size(); i++)
+    {
+        Batch_Worker &w = workers[i];
+        cerr << "   thread " << i << ": " << w.relations << " relations in " << w.time << " secs ("
+             << (w.time > 0 ? w.relations/w.time : 0) << " relations/sec)" << endl;
+        relations += w.relations;
+        entries += w.entries;
+    }
+    cerr << "[STATS] " << name << " relations: " << relations << " entries: " << entries << " throughput: "
+         << relations/time.get_elapsed_time() << " relations/sec" << endl;
+}
+
+template<class M> void ALL(M& mesh)
+{
+    batched_extraction("VT",mesh.get_vertices_num(),[&mesh](itype v, Batch_Worker &w)
+    {
+        bool is_border;
+        mesh.VT(v,w.ret_v,is_border);
+        w.relations++;
+        w.entries += w.ret_v.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the VT relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;
 
-    time.start();
-    for(int vertexId=0; vertexId<mesh.get_vertices_num(); vertexId++)
+    batched_extraction("VE",mesh.get_vertices_num(),[&mesh](itype v, Batch_Worker &w)
     {
-        vector<Edge> ret = mesh.VE(vertexId);
-        ret.clear();
-    }
-    time.stop();
-    time.print_elapsed_time("[TIME] batched VE extraction: ");
+        mesh.VE(v,w.ret_e);
+        w.relations++;
+        w.entries += w.ret_e.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the VE relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;
 
-    time.start();
-    for(int vid=0; vid<mesh.get_vertices_num(); vid++)
+    batched_extraction("VV",mesh.get_vertices_num(),[&mesh](itype v, Batch_Worker &w)
     {
-        ivect ret = mesh.VV(vid);
-        ret.clear();
-    }
-    time.stop();
-    time.print_elapsed_time("[TIME] batched VV extraction: ");
+        mesh.VV(v,w.ret_v);
+        w.relations++;
+        w.entries += w.ret_v.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the VV relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;
 
+    Timer time;
     time.start();
-    set<Edge> edges;
-    for(int tId=0; tId<mesh.get_triangles_num(); tId++)
-    {
-        Triangle &triangle = mesh.get_triangle(tId);
-        for(int edgePos=0; edgePos<triangle.vertices_num(); edgePos++)
-        {
-            Edge edge = triangle.TE(edgePos);
-            pair<set<Edge>::iterator,bool> iter = edges.insert(edge);
-            if(iter.second)
-            {
-                ivect ret = mesh.ET(edge);
-                ret.clear();
-            }
-        }
-    }
+    mesh.build_edges_index();
     time.stop();
-    time.print_elapsed_time("[TIME] batched ET extraction: ");
-    edges.clear();
+    time.print_elapsed_time("[TIME] building the edges index: ");
+    cerr << "[STATS] edges: " << mesh.get_edges_num() << endl;
+
+    batched_extraction("ET",mesh.get_edges_num(),[&mesh](itype e, Batch_Worker &w)
+    {
+        mesh.ET(e,w.ret_v);
+        w.relations++;
+        w.entries += w.ret_v.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the ET relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;
 
-    time.start();
-    for(int tId=0; tId<mesh.get_triangles_num(); tId++)
+    batched_extraction("EE",mesh.get_edges_num(),[&mesh](itype e, Batch_Worker &w)
     {
-        Triangle &triangle = mesh.get_triangle(tId);
-        for(int edgePos=0; edgePos<triangle.vertices_num(); edgePos++)
-        {
-            Edge edge = triangle.TE(edgePos);
-            pair<set<Edge>::iterator,bool> iter = edges.insert(edge);
-            if(iter.second)//I don't have computed the EE for the current edge
-            {
-                vector<Edge> ret = mesh.EE(edge);
-                ret.clear();
-            }
-        }
-    }
-    time.stop();
-    time.print_elapsed_time("[TIME] batched EE extraction: ");
-    edges.clear();
+        Edge edge = mesh.EV(e);
+        mesh.EE(edge,w.ret_e);
+        w.relations++;
+        w.entries += w.ret_e.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the EE relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;
@@ -123,16 +153,13 @@ template<class M> void ALL(M& mesh)
 
 template<class M> void VT_ALL(M& mesh)
 {
-    Timer time;
-    time.start();
-    for(itype vid=0; vid<mesh.get_vertices_num(); vid++)
+    batched_extraction("VT",mesh.get_vertices_num(),[&mesh](itype v, Batch_Worker &w)
     {
-        bool is_border=false;
-        ivect ret = mesh.VT(vid,is_border);
-        ret.clear();
-    }
-    time.stop();
-    time.print_elapsed_time("[TIME] batched VT extraction: ");
+        bool is_border;
+        mesh.VT(v,w.ret_v,is_border);
+        w.relations++;
+        w.entries += w.ret_v.size();
+    });
 
     cerr << "[MEMORY] peak for extracting the VT relations: " <<
             to_string(MemoryUsage().get_Virtual_Memory_in_MB()) << " Mbs" << std::endl;